@@ -4,8 +4,12 @@ extension = ruby_engine == 'ruby' ? 'mri' : ruby_engine
 require 'mkmf'
 $CPPFLAGS << " -DRUBY_VERSION=#{RUBY_VERSION.tr('.', '')}"
 if extension == 'mri'
-  if RUBY_VERSION >= '3.2.0'
+  if RUBY_VERSION >= '3.3.0'
+    $CPPFLAGS << " -Imri/3.3.0"
+  elsif RUBY_VERSION >= '3.2.0'
     $CPPFLAGS << " -Imri/3.2.0"
+  elsif RUBY_VERSION >= '3.1.0'
+    $CPPFLAGS << " -Imri/3.1.0"
   elsif RUBY_VERSION >= '3.0.0'
     $CPPFLAGS << " -Imri/3.0.0"
   else
@@ -30,6 +30,14 @@ public class JRubyAdapter extends RubyObject {
     return result;
   }
 
+  @JRubyMethod(name = "method_table_signature")
+  public static IRubyObject methodTableSignature(ThreadContext context, IRubyObject self, IRubyObject module) {
+    Ruby runtime = context.getRuntime();
+    if (!(module instanceof RubyModule))
+      throw runtime.newTypeError("expected Module, got: " + module.inspect().toString());
+    return runtime.newFixnum(((RubyModule)module).getGeneration());
+  }
+
   @JRubyMethod(name = "singleton_instance")
   public static IRubyObject singletonInstance(ThreadContext context, IRubyObject self, IRubyObject singleton_class) {
     Ruby runtime = context.getRuntime();
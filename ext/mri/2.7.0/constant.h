@@ -0,0 +1,39 @@
+#ifndef CONSTANT_H
+#define CONSTANT_H
+/**********************************************************************
+
+  constant.h -
+
+  $Author$
+  created at: Sun Nov 15 00:09:33 2009
+
+  Copyright (C) 2009 Yusuke Endoh
+
+**********************************************************************/
+#include "ruby/ruby.h"
+
+typedef enum {
+    CONST_DEPRECATED = 0x100,
+
+    CONST_VISIBILITY_MASK = 0xff,
+    CONST_PUBLIC    = 0x00,
+    CONST_PRIVATE,
+    CONST_VISIBILITY_MAX
+} rb_const_flag_t;
+
+#define RB_CONST_PRIVATE_P(ce) \
+    (((ce)->flag & CONST_VISIBILITY_MASK) == CONST_PRIVATE)
+#define RB_CONST_PUBLIC_P(ce) \
+    (((ce)->flag & CONST_VISIBILITY_MASK) == CONST_PUBLIC)
+
+#define RB_CONST_DEPRECATED_P(ce) \
+    ((ce)->flag & CONST_DEPRECATED)
+
+typedef struct rb_const_entry_struct {
+    rb_const_flag_t flag;
+    int line;
+    VALUE value;            /* should be mark */
+    VALUE file;             /* should be mark */
+} rb_const_entry_t;
+
+#endif /* CONSTANT_H */
@@ -1,42 +1,1071 @@
+#define VM_ASSERT(expr) ((void)0)
+
 #include "ruby.h"
+#include "internal.h"
+#if RUBY_VERSION >= 300
+#include "internal/class.h"
+#endif
+#include "method.h"
+#include "constant.h"
+
+/* Exported from libruby, but declared only in its private headers. */
+VALUE rb_iseq_path(const rb_iseq_t *iseq);
+VALUE rb_iseq_first_lineno(const rb_iseq_t *iseq);
+const rb_iseq_t *rb_proc_get_iseq(VALUE proc, int *is_proc);
+void rb_objspace_each_objects(int (*callback)(void *start, void *end, size_t stride, void *data), void *data);
+int rb_objspace_internal_object_p(VALUE obj);
+int rb_objspace_markable_object_p(VALUE obj);
 
-#if RUBY_VERSION < 320
 /*
- * Return the list of undefined instance methods (as Symbols) of the
- * given internal class.
+ * The layout of struct rb_id_table is private to id_table.c, and
+ * rb_id_table_foreach is not exported from libruby, so we walk the
+ * table's items ourselves. This layout has not changed since MRI 2.4.
  */
-VALUE Looksee_internal_undefined_instance_methods(VALUE self, VALUE klass) {
-  static int warned = 0;
-  if (!warned) {
-    rb_warn("Looksee cannot display undef-ed methods on MRI < 3.2");
-    warned = 1;
+typedef struct {
+  uint32_t key;
+#if SIZEOF_VALUE == 8
+  int collision;
+#endif
+  VALUE value;
+} Looksee_id_table_item;
+
+typedef struct {
+  int capa;
+  int num;
+  int used;
+  Looksee_id_table_item *items;
+} Looksee_id_table;
+
+#if SIZEOF_VALUE == 8
+#define ITEM_KEY_ISSET(table, i) ((table)->items[i].key)
+#else
+#define ITEM_KEY_ISSET(table, i) ((table)->items[i].key >> 1)
+#endif
+
+/*
+ * Call func with each value in the given method table.
+ */
+static void each_method_entry(struct rb_id_table *m_tbl, void (*func)(const rb_method_entry_t *, void *), void *data) {
+  Looksee_id_table *table = (Looksee_id_table *)m_tbl;
+  int i;
+  if (!table)
+    return;
+  for (i = 0; i < table->capa; i++) {
+    if (ITEM_KEY_ISSET(table, i))
+      func((const rb_method_entry_t *)table->items[i].value, data);
   }
-  return rb_ary_new();
 }
+
+#if SIZEOF_VALUE == 8
+#define ITEM_GET_KEY(table, i) ((table)->items[i].key)
+#define ITEM_COLLIDED(table, i) ((table)->items[i].collision)
+#else
+#define ITEM_GET_KEY(table, i) ((table)->items[i].key >> 1)
+#define ITEM_COLLIDED(table, i) ((table)->items[i].key & 1)
 #endif
 
-VALUE Looksee_singleton_instance(VALUE self, VALUE klass) {
-  if (!SPECIAL_CONST_P(klass) && BUILTIN_TYPE(klass) == T_CLASS && FL_TEST(klass, FL_SINGLETON)) {
+/*
+ * RUBY_ID_SCOPE_SHIFT is private to symbol.h. It has been 4 since MRI
+ * 2.2.
+ */
+#define LOOKSEE_ID_SCOPE_SHIFT 4
+
+/*
+ * Return the entry stored under the given key in the given method
+ * table if it is for the given method, or NULL. This probes the table
+ * as id_table.c does. Empty slots have a key of 0, which no entry has,
+ * so that key is never looked up.
+ */
+static const rb_method_entry_t *lookup_method_entry(Looksee_id_table *table, uint32_t key, ID id) {
+  const rb_method_entry_t *me;
+  int mask, i, d = 1;
+  if (!key || table->capa <= 0)
+    return NULL;
+  mask = table->capa - 1;
+  i = key & mask;
+  while (key != ITEM_GET_KEY(table, i)) {
+    if (!ITEM_COLLIDED(table, i))
+      return NULL;
+    i = (i + d) & mask;
+    d++;
+  }
+  me = (const rb_method_entry_t *)table->items[i].value;
+  return me && me->called_id == id ? me : NULL;
+}
+
+/*
+ * Return the entry for the given method in the given method table, or
+ * NULL if there is none.
+ *
+ * Items are keyed by the ID's serial number: the ID without its scope
+ * bits, or the ID itself for operators. Which of these applies depends
+ * on a parser token number private to MRI, so we try both, checking
+ * the entry found against the ID.
+ */
+static const rb_method_entry_t *find_method_entry(struct rb_id_table *m_tbl, ID id) {
+  Looksee_id_table *table = (Looksee_id_table *)m_tbl;
+  const rb_method_entry_t *me;
+  if (!table)
+    return NULL;
+  me = lookup_method_entry(table, (uint32_t)(id >> LOOKSEE_ID_SCOPE_SHIFT), id);
+  if (!me && id == (uint32_t)id)
+    me = lookup_method_entry(table, (uint32_t)id, id);
+  return me;
+}
+
+/*
+ * Return the method table holding the methods defined directly in the
+ * given module. If modules have been prepended, this belongs to the
+ * origin class.
+ */
+static struct rb_id_table *module_method_table(VALUE mod) {
+  return RCLASS_M_TBL(RCLASS_ORIGIN(mod));
+}
+
+static VALUE sym_public, sym_protected, sym_private, sym_undefined;
+
+static int singleton_class_p(VALUE klass);
+
+/*
+ * Return the visibility of the given method entry as one of :public,
+ * :protected, :private or :undefined, or nil if the entry should not
+ * be listed.
+ *
+ * This mirrors what Module#*_instance_methods(false) and
+ * Module#undefined_instance_methods report.
+ */
+static VALUE method_entry_visibility(const rb_method_entry_t *me) {
+  if (me->def && me->def->type == VM_METHOD_TYPE_REFINED) {
+    /* Refinement placeholder: show the method it refines, if any. */
+    const rb_method_entry_t *orig_me = me->def->body.refined.orig_me;
+    if (!orig_me || orig_me->owner != me->owner)
+      return Qnil;
+    me = orig_me;
+  }
+  if (UNDEFINED_METHOD_ENTRY_P(me))
+    return sym_undefined;
+  switch (METHOD_ENTRY_VISI(me)) {
+  case METHOD_VISI_PUBLIC:
+    return sym_public;
+  case METHOD_VISI_PROTECTED:
+    return sym_protected;
+  case METHOD_VISI_PRIVATE:
+    return sym_private;
+  default:
+    return Qnil;
+  }
+}
+
+static void add_method_visibility(const rb_method_entry_t *me, void *data) {
+  VALUE visibility = method_entry_visibility(me);
+  if (visibility != Qnil)
+    rb_hash_aset((VALUE)data, rb_id2str(me->called_id), visibility);
+}
+
+/*
+ * Return a hash of the names of the methods defined directly in the
+ * given module to their visibilities, in a single pass over its method
+ * table.
+ */
+VALUE Looksee_instance_method_visibilities(VALUE self, VALUE mod) {
+  VALUE result;
+  if (!RB_TYPE_P(mod, T_CLASS) && !RB_TYPE_P(mod, T_MODULE))
+    rb_raise(rb_eTypeError, "expected Module, got: %"PRIsVALUE, rb_inspect(mod));
+  result = rb_hash_new();
+  each_method_entry(module_method_table(mod), add_method_visibility, (void *)result);
+  return result;
+}
+
+static void add_method_symbol_visibility(const rb_method_entry_t *me, void *data) {
+  VALUE visibility = method_entry_visibility(me);
+  if (visibility != Qnil)
+    rb_hash_aset((VALUE)data, ID2SYM(me->called_id), visibility);
+}
+
+/*
+ * Like Looksee_instance_method_visibilities, but keyed by Symbol. As
+ * method names are interned IDs, this allocates no strings.
+ */
+VALUE Looksee_instance_method_visibilities_by_symbol(VALUE self, VALUE mod) {
+  VALUE result;
+  if (!RB_TYPE_P(mod, T_CLASS) && !RB_TYPE_P(mod, T_MODULE))
+    rb_raise(rb_eTypeError, "expected Module, got: %"PRIsVALUE, rb_inspect(mod));
+  result = rb_hash_new();
+  each_method_entry(module_method_table(mod), add_method_symbol_visibility, (void *)result);
+  return result;
+}
+
+static VALUE method_type_symbols[VM_METHOD_TYPE_REFINED + 1];
+
+static void init_method_type_symbols(void) {
+  method_type_symbols[VM_METHOD_TYPE_ISEQ] = ID2SYM(rb_intern("iseq"));
+  method_type_symbols[VM_METHOD_TYPE_CFUNC] = ID2SYM(rb_intern("cfunc"));
+  method_type_symbols[VM_METHOD_TYPE_ATTRSET] = ID2SYM(rb_intern("attr_writer"));
+  method_type_symbols[VM_METHOD_TYPE_IVAR] = ID2SYM(rb_intern("attr_reader"));
+  method_type_symbols[VM_METHOD_TYPE_BMETHOD] = ID2SYM(rb_intern("bmethod"));
+  method_type_symbols[VM_METHOD_TYPE_ZSUPER] = ID2SYM(rb_intern("zsuper"));
+  method_type_symbols[VM_METHOD_TYPE_ALIAS] = ID2SYM(rb_intern("alias"));
+  method_type_symbols[VM_METHOD_TYPE_UNDEF] = ID2SYM(rb_intern("undefined"));
+  method_type_symbols[VM_METHOD_TYPE_NOTIMPLEMENTED] = ID2SYM(rb_intern("not_implemented"));
+  method_type_symbols[VM_METHOD_TYPE_OPTIMIZED] = ID2SYM(rb_intern("optimized"));
+  method_type_symbols[VM_METHOD_TYPE_MISSING] = ID2SYM(rb_intern("missing"));
+  method_type_symbols[VM_METHOD_TYPE_REFINED] = ID2SYM(rb_intern("refined"));
+}
+
+/*
+ * Return true if rb_mod_method_arity can handle the given method
+ * definition. It aborts on zsuper methods, which are resolved by Method
+ * objects before their arity is taken.
+ */
+static int arity_known_p(const rb_method_definition_t *def) {
+  switch (def->type) {
+  case VM_METHOD_TYPE_ZSUPER:
+  case VM_METHOD_TYPE_UNDEF:
+  case VM_METHOD_TYPE_REFINED:
+    return 0;
+  case VM_METHOD_TYPE_ALIAS:
+    return arity_known_p(def->body.alias.original_me->def);
+  default:
+    return 1;
+  }
+}
+
+typedef struct {
+  VALUE origin;
+  VALUE names;
+  VALUE visibilities;
+  VALUE types;
+  VALUE original_names;
+  VALUE original_owners;
+  VALUE arities;
+} Looksee_method_metadata;
+
+static void add_method_metadata(const rb_method_entry_t *me, void *data) {
+  Looksee_method_metadata *metadata = data;
+  VALUE visibility = method_entry_visibility(me);
+  const rb_method_entry_t *original_me = me;
+  const rb_method_definition_t *def;
+  VALUE type;
+  if (visibility == Qnil)
+    return;
+  if (me->def && me->def->type == VM_METHOD_TYPE_REFINED) {
+    type = method_type_symbols[VM_METHOD_TYPE_REFINED];
+    me = me->def->body.refined.orig_me;
+  } else {
+    type = method_type_symbols[me->def ? me->def->type : VM_METHOD_TYPE_UNDEF];
+  }
+  def = me->def;
+  if (def && def->type == VM_METHOD_TYPE_ALIAS)
+    original_me = def->body.alias.original_me;
+  else if (def && def->original_id != me->called_id && type != method_type_symbols[VM_METHOD_TYPE_REFINED])
+    /* Aliases within a module share the original's definition. */
+    type = method_type_symbols[VM_METHOD_TYPE_ALIAS];
+  rb_ary_push(metadata->names, rb_id2str(me->called_id));
+  rb_ary_push(metadata->visibilities, visibility);
+  rb_ary_push(metadata->types, type);
+  rb_ary_push(metadata->original_names, original_me->def ? rb_id2str(original_me->def->original_id) : Qnil);
+  rb_ary_push(metadata->original_owners, original_me->owner);
+  if (type != method_type_symbols[VM_METHOD_TYPE_REFINED] && def && arity_known_p(def))
+    rb_ary_push(metadata->arities, INT2FIX(rb_mod_method_arity(metadata->origin, me->called_id)));
+  else
+    rb_ary_push(metadata->arities, Qnil);
+}
+
+/*
+ * Return metadata for the methods defined directly in the given module,
+ * in a single pass over its method table, as an array of parallel
+ * arrays:
+ *
+ *   [names, visibilities, types, original_names, original_owners, arities]
+ *
+ * Types are those of the method definitions (:iseq, :cfunc,
+ * :attr_reader, :alias, etc.). Original names and owners are those of
+ * the method the entry was aliased from, or of the entry itself. Arity
+ * is nil where it cannot be determined without resolving the method.
+ */
+VALUE Looksee_internal_method_metadata(VALUE self, VALUE mod) {
+  Looksee_method_metadata metadata;
+  if (!RB_TYPE_P(mod, T_CLASS) && !RB_TYPE_P(mod, T_MODULE))
+    rb_raise(rb_eTypeError, "expected Module, got: %"PRIsVALUE, rb_inspect(mod));
+  metadata.origin = RCLASS_ORIGIN(mod);
+  metadata.names = rb_ary_new();
+  metadata.visibilities = rb_ary_new();
+  metadata.types = rb_ary_new();
+  metadata.original_names = rb_ary_new();
+  metadata.original_owners = rb_ary_new();
+  metadata.arities = rb_ary_new();
+  each_method_entry(module_method_table(mod), add_method_metadata, &metadata);
+  return rb_ary_new_from_args(6, metadata.names, metadata.visibilities, metadata.types,
+                              metadata.original_names, metadata.original_owners, metadata.arities);
+}
+
+typedef struct {
+  VALUE files;
+  VALUE file_indices;
+  VALUE names;
+  VALUE method_file_indices;
+  VALUE lines;
+} Looksee_source_locations;
+
+/*
+ * Return the index of the given file in the file table, adding it if
+ * necessary.
+ */
+static VALUE source_file_index(Looksee_source_locations *locations, VALUE file) {
+  VALUE index = rb_hash_lookup(locations->file_indices, file);
+  if (index == Qnil) {
+    index = LONG2FIX(RARRAY_LEN(locations->files));
+    rb_ary_push(locations->files, file);
+    rb_hash_aset(locations->file_indices, file, index);
+  }
+  return index;
+}
+
+static int iseq_source_location(const rb_iseq_t *iseq, VALUE *file, VALUE *line) {
+  if (!iseq)
+    return 0;
+  *file = rb_iseq_path(iseq);
+  *line = rb_iseq_first_lineno(iseq);
+  return 1;
+}
+
+/*
+ * Set *file and *line to the source location of the given method entry,
+ * as Method#source_location would, except that zsuper entries are not
+ * resolved to their super method. Return 0 if there is none.
+ */
+static int method_entry_source_location(const rb_method_entry_t *me, VALUE *file, VALUE *line) {
+  const rb_method_definition_t *def = me ? me->def : NULL;
+  VALUE attr_location;
+  if (!def)
+    return 0;
+  switch (def->type) {
+  case VM_METHOD_TYPE_ISEQ:
+    return iseq_source_location(def->body.iseq.iseqptr, file, line);
+  case VM_METHOD_TYPE_BMETHOD:
+    return iseq_source_location(rb_proc_get_iseq(def->body.bmethod.proc, NULL), file, line);
+  case VM_METHOD_TYPE_ATTRSET:
+  case VM_METHOD_TYPE_IVAR:
+    attr_location = def->body.attr.location;
+    if (!RB_TYPE_P(attr_location, T_ARRAY))
+      return 0;
+    *file = RARRAY_AREF(attr_location, 0);
+    *line = RARRAY_AREF(attr_location, 1);
+    return 1;
+  case VM_METHOD_TYPE_ALIAS:
+    return method_entry_source_location(def->body.alias.original_me, file, line);
+  case VM_METHOD_TYPE_REFINED:
+    return method_entry_source_location(def->body.refined.orig_me, file, line);
+  default:
+    return 0;
+  }
+}
+
+static void add_source_location(const rb_method_entry_t *me, void *data) {
+  Looksee_source_locations *locations = data;
+  VALUE file, line;
+  if (method_entry_visibility(me) == Qnil || UNDEFINED_METHOD_ENTRY_P(me))
+    return;
+  rb_ary_push(locations->names, rb_id2str(me->called_id));
+  if (method_entry_source_location(me, &file, &line)) {
+    rb_ary_push(locations->method_file_indices, source_file_index(locations, file));
+    rb_ary_push(locations->lines, line);
+  } else {
+    rb_ary_push(locations->method_file_indices, Qnil);
+    rb_ary_push(locations->lines, Qnil);
+  }
+}
+
+/*
+ * Return the source locations of the methods defined directly in the
+ * given module, in a single pass over its method table, as:
+ *
+ *   [files, names, file_indices, lines]
+ *
+ * where files is a table of the distinct source files, and the rest are
+ * parallel arrays giving each method's index into the file table and
+ * line number (both nil if the method has no source location).
+ */
+VALUE Looksee_internal_source_locations(VALUE self, VALUE mod) {
+  Looksee_source_locations locations;
+  if (!RB_TYPE_P(mod, T_CLASS) && !RB_TYPE_P(mod, T_MODULE))
+    rb_raise(rb_eTypeError, "expected Module, got: %"PRIsVALUE, rb_inspect(mod));
+  locations.files = rb_ary_new();
+  locations.file_indices = rb_hash_new();
+  locations.names = rb_ary_new();
+  locations.method_file_indices = rb_ary_new();
+  locations.lines = rb_ary_new();
+  each_method_entry(module_method_table(mod), add_source_location, &locations);
+  return rb_ary_new_from_args(4, locations.files, locations.names, locations.method_file_indices, locations.lines);
+}
+
+static int collect_modules(void *start, void *end, size_t stride, void *data) {
+  VALUE v;
+  for (v = (VALUE)start; v != (VALUE)end; v += stride) {
+    if (!RBASIC(v)->flags || rb_objspace_internal_object_p(v))
+      continue;
+    if (BUILTIN_TYPE(v) == T_CLASS || BUILTIN_TYPE(v) == T_MODULE)
+      rb_ary_push((VALUE)data, v);
+  }
+  return 0;
+}
+
+typedef struct {
+  VALUE index;
+  VALUE mod;
+} Looksee_index_builder;
+
+static void add_method_index_entry(const rb_method_entry_t *me, void *data) {
+  Looksee_index_builder *method_index = data;
+  VALUE visibility = method_entry_visibility(me);
+  VALUE name, owners;
+  if (visibility == Qnil)
+    return;
+  name = ID2SYM(me->called_id);
+  owners = rb_hash_lookup(method_index->index, name);
+  if (owners == Qnil) {
+    owners = rb_ary_new_capa(2);
+    rb_hash_aset(method_index->index, name, owners);
+  }
+  rb_ary_push(owners, method_index->mod);
+  rb_ary_push(owners, visibility);
+}
+
+/*
+ * Return a hash of the name (as a Symbol) of every method defined in
+ * every module in the heap to a flat array of the modules defining it
+ * and the method's visibility in each, as [mod1, visibility1, mod2,
+ * visibility2, ...].
+ *
+ * The heap is walked once to collect the modules, and each method table
+ * is scanned once. Included classes (T_ICLASS) are skipped: they share
+ * the method table of their module, and origin classes are scanned as
+ * part of the class they belong to.
+ */
+VALUE Looksee_internal_method_index(VALUE self) {
+  Looksee_index_builder method_index;
+  VALUE modules = rb_ary_new();
+  long i;
+  rb_objspace_each_objects(collect_modules, (void *)modules);
+  method_index.index = rb_hash_new();
+  for (i = 0; i < RARRAY_LEN(modules); i++) {
+    method_index.mod = RARRAY_AREF(modules, i);
+    each_method_entry(module_method_table(method_index.mod), add_method_index_entry, &method_index);
+  }
+  RB_GC_GUARD(modules);
+  return method_index.index;
+}
+
+/*
+ * A 64-bit finalizer (from SplitMix64), used to spread method table
+ * entries over the signature.
+ */
+static uint64_t mix64(uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+static void add_method_signature(const rb_method_entry_t *me, void *data) {
+  VALUE visibility = method_entry_visibility(me);
+  uint64_t code;
+  if (visibility == Qnil)
+    return;
+  code = visibility == sym_public ? 1 : visibility == sym_protected ? 2 : visibility == sym_private ? 3 : 4;
+  *(uint64_t *)data += mix64(((uint64_t)me->called_id << 3) | code);
+}
+
+/*
+ * Return an Integer which changes whenever the result of
+ * instance_method_visibilities for the given module would change.
+ *
+ * This is a digest of the names and visibilities in the module's method
+ * table, computed without allocating. It does not depend on object
+ * addresses, so it is stable across GC.compact, and since the order of
+ * entries is ignored, across method table resizes.
+ */
+VALUE Looksee_method_table_signature(VALUE self, VALUE mod) {
+  uint64_t signature = 0;
+  if (!RB_TYPE_P(mod, T_CLASS) && !RB_TYPE_P(mod, T_MODULE))
+    rb_raise(rb_eTypeError, "expected Module, got: %"PRIsVALUE, rb_inspect(mod));
+  each_method_entry(module_method_table(mod), add_method_signature, &signature);
+  return LONG2FIX((long)(signature & FIXNUM_MAX));
+}
+
+/*
+ * Return true if the given singleton class belongs in its object's
+ * lookup path: that is, if it has methods of its own, or modules have
+ * been included into or prepended to it.
+ */
+static int singleton_class_has_contents(VALUE singleton_class) {
+  VALUE origin = RCLASS_ORIGIN(singleton_class);
+  Looksee_id_table *table = (Looksee_id_table *)RCLASS_M_TBL(origin);
+  if (table && table->num > 0)
+    return 1;
+  return origin != singleton_class || RB_TYPE_P(RCLASS_SUPER(singleton_class), T_ICLASS);
+}
+
+/*
+ * Return the class at which the object's lookup path starts. This is
+ * the singleton class, if the object has a non-empty one, or its class
+ * otherwise. A singleton class is never created for the object, except
+ * for classes, whose lookup path always starts at their metaclass.
+ */
+static VALUE lookup_start(VALUE object) {
+  VALUE klass;
+  if (SPECIAL_CONST_P(object))
+    return rb_class_of(object);
+  if (BUILTIN_TYPE(object) == T_CLASS)
+    return rb_singleton_class(object);
+  klass = RBASIC(object)->klass;
+  if (FL_TEST(klass, FL_SINGLETON) && singleton_class_has_contents(klass))
+    return klass;
+  return rb_obj_class(object);
+}
+
+/*
+ * Return the chain of classes and modules which comprise the object's
+ * method lookup path.
+ *
+ * This walks the superclass chain directly, resolving included classes
+ * to their modules and skipping classes whose methods have been moved
+ * to an origin class by Module#prepend, as Module#ancestors does.
+ */
+VALUE Looksee_internal_lookup_modules(VALUE self, VALUE object) {
+  VALUE result = rb_ary_new();
+  VALUE klass;
+  for (klass = lookup_start(object); klass; klass = RCLASS_SUPER(klass)) {
+    if (klass != RCLASS_ORIGIN(klass))
+      continue;
+    if (BUILTIN_TYPE(klass) == T_ICLASS)
+      rb_ary_push(result, RBASIC(klass)->klass);
+    else
+      rb_ary_push(result, klass);
+  }
+  return result;
+}
+
+/*
+ * Return the modules in the object's lookup path which define the
+ * named method, in the order super would call them, as a flat array of
+ * module, visibility, module, visibility... The walk stops at the first
+ * module which undefines the method, which is included with visibility
+ * :undefined, as nothing past it can be called.
+ *
+ * This walks the superclass chain as Looksee_internal_lookup_modules
+ * does, but builds no lookup path: only the method tables are
+ * consulted, with one lookup in each.
+ */
+VALUE Looksee_internal_resolve(VALUE self, VALUE object, VALUE name) {
+  VALUE result = rb_ary_new();
+  VALUE klass;
+  ID id = rb_check_id(&name);
+  if (!id)
+    return result;
+  for (klass = lookup_start(object); klass; klass = RCLASS_SUPER(klass)) {
+    const rb_method_entry_t *me;
+    VALUE visibility;
+    if (klass != RCLASS_ORIGIN(klass))
+      continue;
+    if (!(me = find_method_entry(RCLASS_M_TBL(klass), id)))
+      continue;
+    if ((visibility = method_entry_visibility(me)) == Qnil)
+      continue;
+    rb_ary_push(result, BUILTIN_TYPE(klass) == T_ICLASS ? RBASIC(klass)->klass : klass);
+    rb_ary_push(result, visibility);
+    if (visibility == sym_undefined)
+      break;
+  }
+  return result;
+}
+
+#ifndef RCLASS_SUBCLASSES
+#define RCLASS_SUBCLASSES(c) (RCLASS_EXT(c)->subclasses)
+#endif
+
+typedef struct {
+  VALUE mod;
+  ID id;
+  st_table *seen;
+  st_table *indexes;
+} Looksee_override_search;
+
+/*
+ * Return the node for the given module in the given list of override
+ * nodes, adding it if necessary.
+ *
+ * Each list of nodes is indexed by module in its own table in
+ * search->indexes, as a module included in several classes has a node
+ * under each of them.
+ */
+static VALUE override_node(Looksee_override_search *search, VALUE nodes, VALUE mod, VALUE visibility) {
+  st_data_t index, node;
+  if (!st_lookup(search->indexes, (st_data_t)nodes, &index)) {
+    index = (st_data_t)st_init_numtable();
+    st_insert(search->indexes, (st_data_t)nodes, index);
+  }
+  if (st_lookup((st_table *)index, (st_data_t)mod, &node))
+    return (VALUE)node;
+  node = (st_data_t)rb_ary_new_from_args(3, mod, visibility, rb_ary_new());
+  rb_ary_push(nodes, (VALUE)node);
+  st_insert((st_table *)index, (st_data_t)mod, node);
+  return (VALUE)node;
+}
+
+static int free_override_index(st_data_t nodes, st_data_t index, st_data_t arg) {
+  st_free_table((st_table *)index);
+  return ST_CONTINUE;
+}
+
+/*
+ * Return true if the given module is a refinement. MRI keeps the class
+ * it refines in a hidden instance variable.
+ */
+static int refinement_p(VALUE mod) {
+  return RB_TYPE_P(mod, T_MODULE) && !NIL_P(rb_attr_get(mod, rb_intern("__refined_class__")));
+}
+
+/*
+ * Add overrides of the method found in classes below klass to nodes.
+ *
+ * The subclass list of a class holds every class, included class and
+ * origin class whose superclass it is, and that of a module holds the
+ * classes which include it into a lookup path. Each of these is checked
+ * for the method in its own table, as method lookup would: included
+ * classes stand for their module at that point in the hierarchy, and
+ * origin classes for the class whose methods they hold. Refinements
+ * are skipped: their superclass is the class they refine, but their
+ * methods only apply where they are activated.
+ */
+static void collect_overrides(VALUE klass, Looksee_override_search *search, VALUE nodes) {
+  struct rb_subclass_entry *entry;
+  for (entry = RCLASS_SUBCLASSES(klass); entry; entry = entry->next) {
+    VALUE subclass = entry->klass;
+    VALUE owner, children = nodes;
+    const rb_method_entry_t *me;
+    if (!subclass || !rb_objspace_markable_object_p(subclass))
+      continue;
+    if (st_insert(search->seen, (st_data_t)subclass, 0))
+      continue;
+    owner = BUILTIN_TYPE(subclass) == T_ICLASS ? RBASIC(subclass)->klass : subclass;
+    if (owner && owner != search->mod && !rb_objspace_internal_object_p(owner) &&
+        !refinement_p(owner) &&
+        (me = find_method_entry(RCLASS_M_TBL(subclass), search->id))) {
+      VALUE visibility = method_entry_visibility(me);
+      if (visibility != Qnil)
+        children = RARRAY_AREF(override_node(search, nodes, owner, visibility), 2);
+    }
+    collect_overrides(subclass, search, children);
+  }
+}
+
+static VALUE overrides_below_body(VALUE data) {
+  VALUE *args = (VALUE *)data;
+  Looksee_override_search *search = (Looksee_override_search *)args[2];
+  collect_overrides(args[0], search, args[1]);
+  return args[1];
+}
+
+static VALUE overrides_below_ensure(VALUE data) {
+  VALUE *args = (VALUE *)data;
+  Looksee_override_search *search = (Looksee_override_search *)args[2];
+  st_free_table(search->seen);
+  st_foreach(search->indexes, free_override_index, 0);
+  st_free_table(search->indexes);
+  if (args[3] == Qfalse)
+    rb_gc_enable();
+  return Qnil;
+}
+
+/*
+ * Return the tree of modules below the given module which define the
+ * named method, found by walking subclass lists rather than the heap.
+ *
+ * Each node is an array of [module, visibility, children], where the
+ * children are the nodes for the nearest overriding modules below that
+ * one. The GC is disabled during the walk, so classes cannot be freed
+ * while their subclass list entries are being followed.
+ */
+VALUE Looksee_internal_overrides_below(VALUE self, VALUE mod, VALUE name) {
+  Looksee_override_search search;
+  VALUE args[4];
+  if (!RB_TYPE_P(mod, T_CLASS) && !RB_TYPE_P(mod, T_MODULE))
+    rb_raise(rb_eTypeError, "expected Module, got: %"PRIsVALUE, rb_inspect(mod));
+  search.mod = mod;
+  search.id = rb_check_id(&name);
+  if (!search.id)
+    return rb_ary_new();
+  search.seen = st_init_numtable();
+  search.indexes = st_init_numtable();
+  args[0] = mod;
+  args[1] = rb_ary_new();
+  args[2] = (VALUE)&search;
+  args[3] = rb_gc_disable();
+  return rb_ensure(overrides_below_body, (VALUE)args, overrides_below_ensure, (VALUE)args);
+}
+
+/*
+ * Add the memory used by the given method table, as id_table.c's
+ * rb_id_table_memsize computes it, along with its size and capacity,
+ * to the three counters at usage.
+ */
+static void add_table_usage(long *usage, struct rb_id_table *tbl) {
+  Looksee_id_table *table = (Looksee_id_table *)tbl;
+  if (!table)
+    return;
+  usage[0] += sizeof(Looksee_id_table) + sizeof(Looksee_id_table_item) * table->capa;
+  usage[1] += table->num;
+  usage[2] += table->capa;
+}
+
+/*
+ * Add the usage of the method caches of the given class, which may be
+ * an included class, to usage: the callable method entry table to
+ * usage[3..5], and the call cache table (MRI >= 3.0) to usage[6..8].
+ */
+static void add_cache_usage(long *usage, VALUE klass) {
+  add_table_usage(usage + 3, RCLASS_CALLABLE_M_TBL(klass));
+#if RUBY_VERSION >= 300
+  add_table_usage(usage + 6, RCLASS_CC_TBL(klass));
+#endif
+}
+
+/*
+ * Return a hash of :m_tbl, :callable_m_tbl and :cc_tbl to [memsize,
+ * size, capacity] for the given module's method table and method
+ * caches, where memsize is in bytes.
+ *
+ * The caches for methods defined in a module are kept by the classes
+ * which include it into lookup paths, so for modules, those of each
+ * included class are added up. The method table itself is shared with
+ * them and counted once.
+ */
+VALUE Looksee_method_table_usage(VALUE self, VALUE mod) {
+  long usage[9] = {0};
+  VALUE origin, result;
+  int i;
+  if (!RB_TYPE_P(mod, T_CLASS) && !RB_TYPE_P(mod, T_MODULE))
+    rb_raise(rb_eTypeError, "expected Module, got: %"PRIsVALUE, rb_inspect(mod));
+  origin = RCLASS_ORIGIN(mod);
+  add_table_usage(usage, RCLASS_M_TBL(origin));
+  add_cache_usage(usage, mod);
+  if (origin != mod)
+    add_cache_usage(usage, origin);
+  if (RB_TYPE_P(mod, T_MODULE)) {
+    struct rb_subclass_entry *entry;
+    for (entry = RCLASS_SUBCLASSES(mod); entry; entry = entry->next) {
+      if (entry->klass && RB_TYPE_P(entry->klass, T_ICLASS))
+        add_cache_usage(usage, entry->klass);
+    }
+  }
+  result = rb_hash_new();
+  for (i = 0; i < 3; i++) {
+    VALUE counts = rb_ary_new_from_args(3, LONG2NUM(usage[3*i]), LONG2NUM(usage[3*i + 1]), LONG2NUM(usage[3*i + 2]));
+    rb_hash_aset(result, ID2SYM(rb_intern(i == 0 ? "m_tbl" : i == 1 ? "callable_m_tbl" : "cc_tbl")), counts);
+  }
+  return result;
+}
+
+#if RUBY_VERSION >= 300
+/*
+ * The leading fields of struct rb_class_cc_entries, the value type of
+ * a class's call cache table. It is declared in vm_callinfo.h, which is
+ * private to the VM; these fields are the same in MRI 3.0 to 3.3.
+ */
+typedef struct {
+  int capa;
+  int len;
+  const rb_callable_method_entry_t *cme;
+} Looksee_class_cc_entries;
+#endif
+
+/*
+ * Return a hash of each module to a hash of the names (as Symbols) of
+ * its methods which have been called on instances of the given
+ * object's class with call caches to the number of call cache entries
+ * for each, or nil if call caches are not kept per class (MRI < 3.0).
+ *
+ * There is one entry for each distinct way the method has been called
+ * (argument count, splats, keywords, and so on), so this counts call
+ * shapes rather than call sites. The method is attributed to the module
+ * defining the method entry the caches resolved to.
+ */
+VALUE Looksee_call_cache_counts(VALUE self, VALUE object) {
+#if RUBY_VERSION >= 300
+  Looksee_id_table *table = (Looksee_id_table *)RCLASS_CC_TBL(CLASS_OF(object));
+  VALUE result = rb_hash_new();
+  VALUE *owners, *names, *counts, buffer;
+  long size;
+  int i, n = 0;
+  if (!table)
+    return result;
+  /*
+   * Copy the entries out before allocating anything, as the GC may free
+   * entries for invalidated methods and delete them from the table.
+   */
+  size = 3 * (long)table->capa;
+  owners = ALLOCV_N(VALUE, buffer, size);
+  names = owners + table->capa;
+  counts = names + table->capa;
+  for (i = 0; i < table->capa; i++) {
+    const Looksee_class_cc_entries *ccs;
+    if (!ITEM_KEY_ISSET(table, i))
+      continue;
+    ccs = (const Looksee_class_cc_entries *)table->items[i].value;
+    if (!ccs || !ccs->cme || ccs->len == 0 || METHOD_ENTRY_INVALIDATED(ccs->cme))
+      continue;
+    owners[n] = ccs->cme->owner;
+    names[n] = ID2SYM(ccs->cme->called_id);
+    counts[n] = INT2FIX(ccs->len);
+    n++;
+  }
+  for (i = 0; i < n; i++) {
+    VALUE methods = rb_hash_lookup(result, owners[i]);
+    if (methods == Qnil) {
+      methods = rb_hash_new();
+      rb_hash_aset(result, owners[i], methods);
+    }
+    rb_hash_aset(methods, names[i], counts[i]);
+  }
+  ALLOCV_END(buffer);
+  return result;
+#else
+  return Qnil;
+#endif
+}
+
+typedef struct {
+  st_table *instances;
+  st_table *singletons;
+  st_table *extensions;
+} Looksee_census_counts;
+
+static int increment_count(st_data_t *key, st_data_t *value, st_data_t arg, int existing) {
+  *value = existing ? *value + 1 : 1;
+  return ST_CONTINUE;
+}
+
+static int count_objects(void *start, void *end, size_t stride, void *data) {
+  Looksee_census_counts *census = data;
+  VALUE v;
+  for (v = (VALUE)start; v != (VALUE)end; v += stride) {
+    VALUE klass, super;
+    if (!RBASIC(v)->flags || rb_objspace_internal_object_p(v))
+      continue;
+    st_update(census->instances, (st_data_t)rb_obj_class(v), increment_count, 0);
+    if (BUILTIN_TYPE(v) == T_CLASS || BUILTIN_TYPE(v) == T_MODULE)
+      continue;
+    klass = RBASIC(v)->klass;
+    if (!singleton_class_p(klass))
+      continue;
+    st_update(census->singletons, (st_data_t)rb_obj_class(v), increment_count, 0);
+    for (super = RCLASS_SUPER(klass); super && BUILTIN_TYPE(super) == T_ICLASS; super = RCLASS_SUPER(super)) {
+      VALUE mod = RBASIC(super)->klass;
+      if (mod != klass)
+        st_update(census->extensions, (st_data_t)mod, increment_count, 0);
+    }
+  }
+  return 0;
+}
+
+static int add_count(st_data_t key, st_data_t value, st_data_t data) {
+  rb_hash_aset((VALUE)data, (VALUE)key, LONG2NUM((long)value));
+  return ST_CONTINUE;
+}
+
+static VALUE count_table_to_hash(st_table *table) {
+  VALUE hash = rb_hash_new();
+  st_foreach(table, add_count, (st_data_t)hash);
+  return hash;
+}
+
+static VALUE census_body(VALUE data) {
+  Looksee_census_counts *census = (Looksee_census_counts *)data;
+  rb_objspace_each_objects(count_objects, census);
+  return rb_ary_new_from_args(3,
+                              count_table_to_hash(census->instances),
+                              count_table_to_hash(census->singletons),
+                              count_table_to_hash(census->extensions));
+}
+
+static VALUE census_ensure(VALUE data) {
+  Looksee_census_counts *census = (Looksee_census_counts *)data;
+  st_free_table(census->instances);
+  st_free_table(census->singletons);
+  st_free_table(census->extensions);
+  return Qnil;
+}
+
+/*
+ * Count the live objects in the heap, in one pass, without calling any
+ * Ruby methods. Return three hashes:
+ *
+ *  - each class to the number of its direct instances
+ *  - each class to the number of its direct instances which have their
+ *    own singleton class (classes and modules are not counted)
+ *  - each module to the number of such objects it has been included
+ *    into the singleton class of, usually by Object#extend
+ *
+ * Singleton classes are detected as for singleton_instance.
+ */
+VALUE Looksee_census(VALUE self) {
+  Looksee_census_counts census;
+  census.instances = st_init_numtable();
+  census.singletons = st_init_numtable();
+  census.extensions = st_init_numtable();
+  return rb_ensure(census_body, (VALUE)&census, census_ensure, (VALUE)&census);
+}
+
+static void add_undefined_method(const rb_method_entry_t *me, void *data) {
+  if (UNDEFINED_METHOD_ENTRY_P(me))
+    rb_ary_push((VALUE)data, ID2SYM(me->called_id));
+}
+
+/*
+ * Return the list of undefined instance methods (as Symbols) of the
+ * given module, like Module#undefined_instance_methods on MRI >= 3.2.
+ */
+VALUE Looksee_internal_undefined_instance_methods(VALUE self, VALUE mod) {
+  VALUE result;
+  if (!RB_TYPE_P(mod, T_CLASS) && !RB_TYPE_P(mod, T_MODULE))
+    rb_raise(rb_eTypeError, "expected Module, got: %"PRIsVALUE, rb_inspect(mod));
+  result = rb_ary_new();
+  each_method_entry(module_method_table(mod), add_undefined_method, (void *)result);
+  return result;
+}
+
+/*
+ * Return the refinement of the given module activated by `using
+ * refiner`, or nil if the refiner does not refine it.
+ *
+ * Module#refine records these in a hidden instance variable of the
+ * refiner, which has no Ruby-level accessor before MRI 3.2.
+ */
+VALUE Looksee_refinement_for(VALUE self, VALUE refiner, VALUE mod) {
+  VALUE refinements;
+  if (!RB_TYPE_P(refiner, T_MODULE))
+    rb_raise(rb_eTypeError, "expected Module, got: %"PRIsVALUE, rb_inspect(refiner));
+  refinements = rb_attr_get(refiner, rb_intern("__refinements__"));
+  if (!RB_TYPE_P(refinements, T_HASH))
+    return Qnil;
+  return rb_hash_lookup(refinements, mod);
+}
+
+static int add_constant(st_data_t key, st_data_t value, st_data_t data) {
+  VALUE *args = (VALUE *)data;
+  ID id = (ID)key;
+  const rb_const_entry_t *ce = (const rb_const_entry_t *)value;
+  VALUE visibility = RB_CONST_PRIVATE_P(ce) ? sym_private : sym_public;
+  VALUE constant = ce->value, autoload = Qnil;
+  if (constant == Qundef) {
+    constant = Qnil;
+    autoload = rb_autoload_p(args[1], id);
+  }
+  rb_hash_aset(args[0], rb_id2str(id), rb_ary_new_from_args(3, visibility, constant, autoload));
+  return ST_CONTINUE;
+}
+
+/*
+ * Return a hash of the names of the constants defined directly in the
+ * given module to [visibility, value, autoload], where visibility is
+ * :public or :private, and autoload is the feature path of a constant
+ * registered with Module#autoload but not yet loaded (in which case
+ * value is nil).
+ *
+ * This reads the constant table directly, so no autoloads are
+ * triggered.
+ */
+VALUE Looksee_constants(VALUE self, VALUE mod) {
+  VALUE args[2];
+  st_table *table;
+  if (!RB_TYPE_P(mod, T_CLASS) && !RB_TYPE_P(mod, T_MODULE))
+    rb_raise(rb_eTypeError, "expected Module, got: %"PRIsVALUE, rb_inspect(mod));
+  args[0] = rb_hash_new();
+  args[1] = mod;
+  table = rb_mod_const_at(mod, NULL);
+  st_foreach(table, add_constant, (st_data_t)args);
+  st_free_table(table);
+  return args[0];
+}
+
+static int singleton_class_p(VALUE klass) {
+  return !SPECIAL_CONST_P(klass) && BUILTIN_TYPE(klass) == T_CLASS && FL_TEST(klass, FL_SINGLETON);
+}
+
+static VALUE attached_object(VALUE singleton_class) {
 #if RUBY_VERSION < 330
-    VALUE object = rb_ivar_get(klass, rb_intern("__attached__"));
+  VALUE object = rb_ivar_get(singleton_class, rb_intern("__attached__"));
 #else
-    VALUE object = rb_class_attached_object(klass);
+  VALUE object = rb_class_attached_object(singleton_class);
 #endif
-    if (object == Qnil)
-      rb_raise(rb_eRuntimeError, "[looksee bug] can't find singleton object");
-    return object;
+  if (object == Qnil)
+    rb_raise(rb_eRuntimeError, "[looksee bug] can't find singleton object");
+  return object;
+}
+
+VALUE Looksee_singleton_instance(VALUE self, VALUE klass) {
+  if (singleton_class_p(klass)) {
+    return attached_object(klass);
   } else {
     return Qnil;
   }
 }
 
+/*
+ * Return the number of singleton classes wrapped around the given
+ * module's base object, and the object itself, as a pair.
+ */
+VALUE Looksee_singleton_nesting(VALUE self, VALUE mod) {
+  int depth = 0;
+  VALUE object = mod;
+  while (singleton_class_p(object)) {
+    object = attached_object(object);
+    depth++;
+  }
+  return rb_assoc_new(INT2FIX(depth), object);
+}
+
+VALUE Looksee_module_name(VALUE self, VALUE mod) {
+  VALUE name;
+  if (!RB_TYPE_P(mod, T_CLASS) && !RB_TYPE_P(mod, T_MODULE))
+    rb_raise(rb_eTypeError, "expected Module, got: %"PRIsVALUE, rb_inspect(mod));
+  name = rb_mod_name(mod);
+  return name == Qnil ? rb_str_new(0, 0) : name;
+}
+
 void Init_mri(void) {
   VALUE mLooksee = rb_const_get(rb_cObject, rb_intern("Looksee"));
   VALUE mAdapter = rb_const_get(mLooksee, rb_intern("Adapter"));
   VALUE mBase = rb_const_get(mAdapter, rb_intern("Base"));
   VALUE mMRI = rb_define_class_under(mAdapter, "MRI", mBase);
-#if RUBY_VERSION < 320
-  rb_define_method(mMRI, "internal_undefined_instance_methods", Looksee_internal_undefined_instance_methods, 1);
+#ifdef HAVE_RB_EXT_RACTOR_SAFE
+  /* Nothing here keeps state beyond the symbols interned below. */
+  rb_ext_ractor_safe(true);
 #endif
+  sym_public = ID2SYM(rb_intern("public"));
+  sym_protected = ID2SYM(rb_intern("protected"));
+  sym_private = ID2SYM(rb_intern("private"));
+  sym_undefined = ID2SYM(rb_intern("undefined"));
+  init_method_type_symbols();
+  rb_define_method(mMRI, "internal_lookup_modules", Looksee_internal_lookup_modules, 1);
+  rb_define_method(mMRI, "internal_resolve", Looksee_internal_resolve, 2);
+  rb_define_method(mMRI, "instance_method_visibilities", Looksee_instance_method_visibilities, 1);
+  rb_define_method(mMRI, "instance_method_visibilities_by_symbol", Looksee_instance_method_visibilities_by_symbol, 1);
+  rb_define_method(mMRI, "internal_method_metadata", Looksee_internal_method_metadata, 1);
+  rb_define_method(mMRI, "internal_source_locations", Looksee_internal_source_locations, 1);
+  rb_define_method(mMRI, "internal_method_index", Looksee_internal_method_index, 0);
+  rb_define_method(mMRI, "internal_overrides_below", Looksee_internal_overrides_below, 2);
+  rb_define_method(mMRI, "method_table_signature", Looksee_method_table_signature, 1);
+  rb_define_method(mMRI, "method_table_usage", Looksee_method_table_usage, 1);
+  rb_define_method(mMRI, "call_cache_counts", Looksee_call_cache_counts, 1);
+  rb_define_method(mMRI, "census", Looksee_census, 0);
+  rb_define_method(mMRI, "internal_undefined_instance_methods", Looksee_internal_undefined_instance_methods, 1);
+  rb_define_method(mMRI, "constants", Looksee_constants, 1);
+  rb_define_method(mMRI, "refinement_for", Looksee_refinement_for, 2);
   rb_define_method(mMRI, "singleton_instance", Looksee_singleton_instance, 1);
+  rb_define_method(mMRI, "singleton_nesting", Looksee_singleton_nesting, 1);
+  rb_define_method(mMRI, "module_name", Looksee_module_name, 1);
 }
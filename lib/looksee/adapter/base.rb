@@ -5,7 +5,25 @@ module Looksee
       # Return the chain of classes and modules which comprise the
       # object's method lookup path.
       #
+      # The hooks installed by Looksee::Churn are left out, as they are
+      # not part of the program being inspected.
+      #
       def lookup_modules(object)
+        modules = internal_lookup_modules(object)
+        modules = modules.reject { |mod| Churn.hook?(mod) } if churn_installed?
+        modules
+      end
+
+      #
+      # Return true if the Churn hooks have been installed.
+      #
+      def churn_installed?
+        # Churn cannot be autoloaded from a non-main Ractor, and has not
+        # been installed if it has not been loaded.
+        Looksee.autoload?(:Churn).nil? && Churn.installed?
+      end
+
+      def internal_lookup_modules(object)
         start =
           begin
             singleton_class = (class << object; self; end)
@@ -16,6 +34,41 @@ module Looksee
         Looksee.safe_call(Module, :ancestors, start)
       end
 
+      #
+      # Return the modules in the object's lookup path which define the
+      # named method, in the order +super+ would call them, as a flat
+      # array:
+      #
+      #   [C, :public, M, :public, ...]
+      #
+      # The array ends at the first module which undefines the method,
+      # with visibility :undefined. The Churn hooks are left out, as in
+      # #lookup_modules.
+      #
+      def resolve(object, name)
+        definitions = internal_resolve(object, name)
+        definitions = without_churn_hooks(definitions) if churn_installed?
+        definitions
+      end
+
+      #
+      # Return the flat array for #resolve.
+      #
+      # This fallback builds the lookup path, and checks every module in
+      # it.
+      #
+      def internal_resolve(object, name)
+        name = name.to_sym
+        result = []
+        lookup_modules(object).each do |mod|
+          visibility = instance_method_visibilities_by_symbol(mod)[name] or
+            next
+          result.push(mod, visibility)
+          break if visibility == :undefined
+        end
+        result
+      end
+
       #
       # Return a description of the given module.
       #
@@ -24,16 +77,13 @@ module Looksee
       def describe_module(mod)
         Module === mod or
           raise TypeError, "expected Module, got: #{mod.inspect}"
-        num_brackets = 0
-        object = mod
-        while (instance = singleton_instance(object))
-          num_brackets += 1
-          object = instance
-        end
+        num_brackets, object = singleton_nesting(mod)
 
         if object.is_a?(Module)
           description = module_name(object)
-          if description.empty?
+          if description.empty? && (refinement = refinement_description(object))
+            description = refinement
+          elsif description.empty?
             is_class = Class === object
             description = "unnamed #{is_class ? 'Class' : 'Module'}"
           end
@@ -48,6 +98,282 @@ module Looksee
         end
       end
 
+      #
+      # Return a hash of the names of the methods defined directly in
+      # the given module to their visibilities (:public, :protected,
+      # :private, or :undefined).
+      #
+      def instance_method_visibilities(mod)
+        instance_method_visibilities_by_symbol(mod).transform_keys(&:to_s)
+      end
+
+      #
+      # Like #instance_method_visibilities, but with the names as
+      # Symbols, which need no strings to be allocated.
+      #
+      def instance_method_visibilities_by_symbol(mod)
+        methods = {}
+        [:public, :protected, :private].each do |visibility|
+          meths = Looksee.safe_call(Module, "#{visibility}_instance_methods", mod, false)
+          meths.each do |method|
+            methods[method] = visibility
+          end
+        end
+        undefined_instance_methods(mod).each do |method|
+          methods[method.to_sym] = :undefined
+        end
+        methods
+      end
+
+      #
+      # Return a MethodMetadata for the methods defined directly in the
+      # given module. It is frozen, so it can be passed between Ractors.
+      #
+      def method_metadata(mod)
+        Module === mod or
+          raise TypeError, "expected Module, got: #{mod.inspect}"
+        Looksee.shareable(MethodMetadata.new(*internal_method_metadata(mod)))
+      end
+
+      #
+      # Return the parallel arrays for a MethodMetadata.
+      #
+      # This fallback builds an UnboundMethod for each method, and can
+      # only tell Ruby methods (:iseq) from C methods (:cfunc), and
+      # aliases from other methods.
+      #
+      def internal_method_metadata(mod)
+        arrays = Array.new(6) { [] }
+        instance_method_visibilities(mod).each do |name, visibility|
+          if visibility == :undefined
+            values = [:undefined, name, mod, nil]
+          else
+            method = Looksee.safe_call(Module, :instance_method, mod, name)
+            original_name = method.original_name.to_s
+            type =
+              if original_name != name
+                :alias
+              elsif method.source_location
+                :iseq
+              else
+                :cfunc
+              end
+            values = [type, original_name, method.owner, method.arity]
+          end
+          [name, visibility, *values].each_with_index { |value, i| arrays[i] << value }
+        end
+        arrays
+      end
+
+      #
+      # Return a SourceLocations for the methods defined directly in the
+      # given module. It is frozen, so it can be passed between Ractors.
+      #
+      def source_locations(mod)
+        Module === mod or
+          raise TypeError, "expected Module, got: #{mod.inspect}"
+        Looksee.shareable(SourceLocations.new(*internal_source_locations(mod)))
+      end
+
+      #
+      # Return the arrays for a SourceLocations.
+      #
+      # This fallback builds an UnboundMethod for each method.
+      #
+      def internal_source_locations(mod)
+        files = []
+        file_indices = {}
+        names = []
+        method_file_indices = []
+        lines = []
+        instance_method_visibilities(mod).each do |name, visibility|
+          next if visibility == :undefined
+          names << name
+          file, line = Looksee.safe_call(Module, :instance_method, mod, name).source_location
+          if file
+            method_file_indices << (file_indices[file] ||= (files << file).size - 1)
+            lines << line
+          else
+            method_file_indices << nil
+            lines << nil
+          end
+        end
+        [files, names, method_file_indices, lines]
+      end
+
+      #
+      # Return a hash of the name (as a Symbol) of every method defined
+      # in every module in the heap to a flat array of the modules
+      # defining it and its visibility in each:
+      #
+      #   {:call => [Proc, :public, Method, :public, ...], ...}
+      #
+      # The Churn hooks are left out, as in #lookup_modules.
+      #
+      def method_index
+        index = internal_method_index
+        if churn_installed?
+          index.each do |name, definitions|
+            index[name] = without_churn_hooks(definitions) if definitions.any? { |mod| Churn.hook?(mod) }
+          end
+        end
+        index
+      end
+
+      #
+      # Return the hash for #method_index.
+      #
+      # This fallback scans every module in the heap.
+      #
+      def internal_method_index
+        index = {}
+        ObjectSpace.each_object(Module) do |mod|
+          instance_method_visibilities(mod).each do |name, visibility|
+            (index[name.to_sym] ||= []).push(mod, visibility)
+          end
+        end
+        index
+      end
+
+      #
+      # Return the tree of modules below +mod+ which define the method
+      # +name+. See Looksee.overrides_below.
+      #
+      # The Churn hooks are left out, as in #lookup_modules, with any
+      # overrides below them taking their place.
+      #
+      def overrides_below(mod, name)
+        nodes = internal_overrides_below(mod, name)
+        nodes = override_nodes_without_churn_hooks(nodes) if churn_installed?
+        nodes
+      end
+
+      #
+      # Return the tree for #overrides_below.
+      #
+      # This fallback scans the heap for modules with +mod+ among their
+      # ancestors.
+      #
+      def internal_overrides_below(mod, name)
+        Module === mod or
+          raise TypeError, "expected Module, got: #{mod.inspect}"
+        name = name.to_s
+        roots = []
+        ObjectSpace.each_object(Module) do |descendant|
+          ancestors = Looksee.safe_call(Module, :ancestors, descendant)
+          index = ancestors.index(mod) or
+            next
+          nodes = roots
+          ancestors[0, index].reverse_each do |ancestor|
+            visibility = instance_method_visibilities(ancestor)[name] or
+              next
+            node = nodes.find { |n| n[0].equal?(ancestor) } or
+              nodes << (node = [ancestor, visibility, []])
+            nodes = node[2]
+          end
+        end
+        roots
+      end
+
+      #
+      # Return a hash of the names of the constants defined directly in
+      # +mod+ to <tt>[visibility, value, autoload]</tt>, where
+      # +visibility+ is :public or :private, and +autoload+ is the path
+      # registered with Module#autoload for a constant which has not
+      # been loaded yet (in which case +value+ is nil). No autoloads are
+      # triggered.
+      #
+      # This fallback cannot see private constants.
+      #
+      def constants(mod)
+        Module === mod or
+          raise TypeError, "expected Module, got: #{mod.inspect}"
+        constants = {}
+        Looksee.safe_call(Module, :constants, mod, false).each do |name|
+          if (path = Looksee.safe_call(Module, :autoload?, mod, name))
+            constants[name.to_s] = [:public, nil, path]
+          else
+            constants[name.to_s] = [:public, Looksee.safe_call(Module, :const_get, mod, name, false), nil]
+          end
+        end
+        constants
+      end
+
+      #
+      # Return the refinement of +mod+ activated by <tt>using
+      # refiner</tt>, or nil if +refiner+ does not refine +mod+.
+      #
+      # This fallback needs Module#refinements (Ruby 3.2).
+      #
+      def refinement_for(refiner, mod)
+        Module.method_defined?(:refinements) or
+          return nil
+        refiner.refinements.find do |refinement|
+          target = refinement.respond_to?(:target) ? refinement.target : refinement.refined_class
+          target.equal?(mod)
+        end
+      end
+
+      #
+      # Count the live objects in the heap. Return three hashes: each
+      # class to the number of its direct instances; each class to the
+      # number of its direct instances which have their own singleton
+      # class (not counting classes and modules); and each module to the
+      # number of such objects whose singleton class includes it
+      # (usually by Object#extend).
+      #
+      # This fallback finds singleton classes among the modules in the
+      # heap, as it cannot ask objects for theirs without creating them.
+      #
+      def census
+        instances = Hash.new(0)
+        singletons = Hash.new(0)
+        extensions = Hash.new(0)
+        ObjectSpace.each_object(BasicObject) do |object|
+          instances[Looksee.safe_call(Kernel, :class, object)] += 1
+        end
+        ObjectSpace.each_object(Class) do |klass|
+          object = singleton_instance(klass)
+          next if object.nil? || object.is_a?(Module)
+          real_class = Looksee.safe_call(Kernel, :class, object)
+          singletons[real_class] += 1
+          ancestors = Looksee.safe_call(Module, :ancestors, klass) -
+            Looksee.safe_call(Module, :ancestors, real_class)
+          ancestors.each { |mod| extensions[mod] += 1 unless mod.equal?(klass) }
+        end
+        [instances, singletons, extensions].map { |counts| Hash[counts] }
+      end
+
+      #
+      # Return a value which changes whenever the result of
+      # #instance_method_visibilities for the given module may change,
+      # or nil if this cannot be determined cheaply, in which case the
+      # module's methods are not cached.
+      #
+      def method_table_signature(mod)
+        nil
+      end
+
+      #
+      # Return a hash of <tt>:m_tbl</tt>, <tt>:callable_m_tbl</tt> and
+      # <tt>:cc_tbl</tt> to <tt>[memsize, size, capacity]</tt> for the
+      # given module's method table and method caches, with +memsize+
+      # in bytes, or nil if these cannot be determined.
+      #
+      def method_table_usage(mod)
+        nil
+      end
+
+      #
+      # Return a hash of each module to a hash of the names (as Symbols)
+      # of its methods which have been called on the given object's
+      # class with call caches to the number of call cache entries for
+      # each, or nil if this cannot be determined.
+      #
+      def call_cache_counts(object)
+        nil
+      end
+
       def undefined_instance_methods(mod)
         if Module.method_defined?(:undefined_instance_methods)
           mod.undefined_instance_methods
@@ -60,6 +386,17 @@ module Looksee
         raise NotImplementedError, "abstract"
       end
 
+      def without_churn_hooks(definitions)
+        definitions.each_slice(2).reject { |mod, _| Churn.hook?(mod) }.flatten(1)
+      end
+
+      def override_nodes_without_churn_hooks(nodes)
+        nodes.flat_map do |mod, visibility, children|
+          children = override_nodes_without_churn_hooks(children)
+          Churn.hook?(mod) ? children : [[mod, visibility, children]]
+        end
+      end
+
       def has_no_methods?(mod)
         [:public, :protected, :private].all? do |visibility|
           Looksee.safe_call(Module, "#{visibility}_instance_methods", mod, false).empty?
@@ -67,15 +404,38 @@ module Looksee
       end
 
       def includes_no_modules?(klass)
-        ancestors = Looksee.safe_call(Module, :ancestors, klass)
-        ancestors.size == 1 ||
-          klass.included_modules == klass.ancestors[1].included_modules
+        superclass = Looksee.safe_call(Class, :superclass, klass)
+        superclass.nil? ||
+          Looksee.safe_call(Module, :included_modules, klass) ==
+            Looksee.safe_call(Module, :included_modules, superclass)
       end
 
       def singleton_instance(singleton_class)
         raise NotImplementedError, "abstract"
       end
 
+      #
+      # Return the number of singleton classes wrapped around the given
+      # module's base object, along with the object itself.
+      #
+      # e.g. for the singleton class of the singleton class of +C+,
+      # return <tt>[2, C]</tt>.
+      #
+      def singleton_nesting(mod)
+        depth = 0
+        object = mod
+        while (instance = singleton_instance(object))
+          depth += 1
+          object = instance
+        end
+        [depth, object]
+      end
+
+      def refinement_description(mod)
+        string = Looksee.safe_call(Module, :to_s, mod)
+        string if string.start_with?('#<refinement:')
+      end
+
       def module_name(mod)
         Looksee.safe_call(Module, :name, mod) || ''
       end
@@ -0,0 +1,120 @@
+module Looksee
+  #
+  # Counts of the live objects in the heap: instances of each class,
+  # instances with their own singleton classes, and the modules those
+  # singleton classes include. Singleton classes defeat inline method
+  # caches, and cost memory per object.
+  #
+  #   census = Looksee::Census.build
+  #   census.singletons(User)  # => number of users with singleton classes
+  #
+  class Census
+    include PrettyPrintHack
+
+    #
+    # Count the objects currently in the heap. The census is frozen, so
+    # it can be passed between Ractors.
+    #
+    def self.build
+      Looksee.shareable(new(*Looksee.adapter.census))
+    end
+
+    #
+    # Create a census from hashes of classes to instance counts, classes
+    # to singleton counts, and modules to extension counts, as returned
+    # by the adapter's +census+.
+    #
+    def initialize(instances, singletons, extensions)
+      @instances = instances
+      @singletons = singletons
+      @extensions = extensions
+    end
+
+    #
+    # Return the number of direct instances of +klass+.
+    #
+    def instances(klass)
+      @instances[klass] || 0
+    end
+
+    #
+    # Return the number of direct instances of +klass+ which have their
+    # own singleton class.
+    #
+    def singletons(klass)
+      @singletons[klass] || 0
+    end
+
+    #
+    # Return the number of objects whose singleton class includes +mod+.
+    #
+    def extensions(mod)
+      @extensions[mod] || 0
+    end
+
+    #
+    # Return the +limit+ classes with the most instances, as [class,
+    # count] pairs.
+    #
+    def top_instances(limit=20)
+      top(@instances, limit)
+    end
+
+    #
+    # Return the +limit+ classes with the most instances with singleton
+    # classes, as [class, count] pairs.
+    #
+    def top_singletons(limit=20)
+      top(@singletons, limit)
+    end
+
+    #
+    # Return the +limit+ modules extending the most objects, as
+    # [module, count] pairs.
+    #
+    def top_extensions(limit=20)
+      top(@extensions, limit)
+    end
+
+    #
+    # Return a summary of the counts for +mod+, like "12 instances, 3
+    # singletons, extends 5", leaving out zero counts.
+    #
+    def describe(mod)
+      parts = []
+      parts << "#{instances(mod)} instances" if instances(mod) > 0
+      parts << "#{singletons(mod)} singletons" if singletons(mod) > 0
+      parts << "extends #{extensions(mod)}" if extensions(mod) > 0
+      parts.join(', ')
+    end
+
+    #
+    # Show the top classes by instances and by singletons, and the top
+    # modules by extensions.
+    #
+    def inspect
+      sections = [
+        ['Instances', top_instances],
+        ['Singletons', top_singletons],
+        ['Extensions', top_extensions],
+      ]
+      lines = []
+      sections.each do |title, rows|
+        next if rows.empty?
+        lines << title
+        width = rows.map { |_, n| n.to_s.size }.max
+        rows.each do |mod, n|
+          name = Looksee.styles[:module] % Looksee.adapter.describe_module(mod)
+          lines << "  #{n.to_s.rjust(width)}  #{name}"
+        end
+      end
+      lines.join("\n")
+    end
+
+    private
+
+    def top(counts, limit)
+      counts.sort_by { |_, n| -n }.first(limit)
+    end
+  end
+end
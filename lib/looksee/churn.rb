@@ -0,0 +1,295 @@
+module Looksee
+  #
+  # Records methods being defined, removed and undefined while running,
+  # to find code which does so on hot paths. Each of these invalidates
+  # method caches.
+  #
+  #   churn = Looksee::Churn.start
+  #   # ... serve some requests ...
+  #   churn  # => modules and call sites, ranked by definitions per second
+  #   Looksee::Churn.stop
+  #
+  # Events are recorded by hooks prepended to Module (method_added,
+  # method_removed, method_undefined, extended) and BasicObject
+  # (singleton_method_added, singleton_method_removed,
+  # singleton_method_undefined). Overrides of these which do not call
+  # +super+ hide their events. Once installed, the hooks stay in place,
+  # but do nothing while no monitor is running, and are left out of
+  # lookup paths, resolutions and override trees.
+  #
+  # Modules are recorded by their descriptions, as in the Inspector, so
+  # the monitor keeps no modules or objects alive.
+  #
+  # Only events in the main Ractor are recorded.
+  #
+  class Churn
+    include PrettyPrintHack
+
+    #
+    # A recorded event.
+    #
+    # +kind+ is one of :added, :removed, :undefined, :singleton_added,
+    # :singleton_removed, :singleton_undefined or :extended. +module+ is
+    # the description of the module whose methods changed, +name+ is
+    # the method name (or for :extended, the description of the
+    # extending module), +site+ is the "file:line" of the code which
+    # made the change, and +backtrace+ is the full backtrace, if sampled
+    # for this event.
+    #
+    Event = Struct.new(:time, :kind, :module, :name, :site, :backtrace)
+
+    MODULE_KINDS = [:added, :removed, :undefined].freeze # :nodoc:
+
+    module ModuleHooks # :nodoc:
+      private
+
+      def method_added(name)
+        Churn.record(:added, self, name)
+        super
+      end
+
+      def method_removed(name)
+        Churn.record(:removed, self, name)
+        super
+      end
+
+      def method_undefined(name)
+        Churn.record(:undefined, self, name)
+        super
+      end
+
+      def extended(object)
+        Churn.record(:extended, object, self)
+        super
+      end
+    end
+
+    module ObjectHooks # :nodoc:
+      private
+
+      def singleton_method_added(name)
+        Churn.record(:singleton_added, self, name)
+        super
+      end
+
+      def singleton_method_removed(name)
+        Churn.record(:singleton_removed, self, name)
+        super
+      end
+
+      def singleton_method_undefined(name)
+        Churn.record(:singleton_undefined, self, name)
+        super
+      end
+    end
+
+    class << self
+      #
+      # The running monitor, or nil.
+      #
+      attr_reader :current
+
+      #
+      # Start a new monitor, replacing the running one, if any, and
+      # return it. See #initialize for options.
+      #
+      def start(options={})
+        install
+        @current = new(options)
+      end
+
+      #
+      # Stop the running monitor, and return it.
+      #
+      def stop
+        monitor, @current = @current, nil
+        monitor
+      end
+
+      #
+      # Return true if a monitor is running.
+      #
+      def running?
+        !@current.nil?
+      end
+
+      #
+      # Return true if the hooks have been installed.
+      #
+      def installed?
+        @installed || false
+      end
+
+      def hook?(mod) # :nodoc:
+        mod.equal?(ModuleHooks) || mod.equal?(ObjectHooks)
+      end
+
+      #
+      # Record an event with the running monitor, if any. For :extended
+      # and the singleton events, +target+ is the object whose singleton
+      # class changed, which is only looked up while a monitor runs.
+      #
+      def record(kind, target, name) # :nodoc:
+        Looksee.main_ractor? or
+          return
+        monitor = @current or
+          return
+        mod = MODULE_KINDS.include?(kind) ? target : Looksee.safe_call(Kernel, :singleton_class, target)
+        location = caller_locations(2, 1).first
+        monitor.record(kind, mod, name, "#{location.path}:#{location.lineno}")
+      end
+
+      private
+
+      def install
+        return if @installed
+        Module.send(:prepend, ModuleHooks)
+        BasicObject.send(:prepend, ObjectHooks)
+        @installed = true
+      end
+    end
+
+    #
+    # Create a monitor. It does not record anything unless started with
+    # Churn.start.
+    #
+    # Options:
+    #
+    #   * +:buffer_size+ - the number of recent events to keep
+    #     (default: 1000)
+    #   * +:backtrace_every+ - record a full backtrace for every Nth
+    #     event (default: 100)
+    #
+    def initialize(options={})
+      @buffer_size = options[:buffer_size] || 1000
+      @backtrace_every = options[:backtrace_every] || 100
+      @module_counts = Hash.new(0)
+      @site_counts = Hash.new(0)
+      @buffer = []
+      @count = 0
+      @started_at = Process.clock_gettime(Process::CLOCK_MONOTONIC)
+      @mutex = Mutex.new
+    end
+
+    #
+    # The total number of events recorded.
+    #
+    attr_reader :count
+
+    #
+    # Return a hash of module descriptions to the number of events
+    # recorded for each.
+    #
+    def module_counts
+      @mutex.synchronize { @module_counts.dup }
+    end
+
+    #
+    # Return a hash of call sites ("file:line") to the number of events
+    # recorded at each.
+    #
+    def site_counts
+      @mutex.synchronize { @site_counts.dup }
+    end
+
+    #
+    # Return the most recent events, oldest first.
+    #
+    def events
+      @mutex.synchronize do
+        start = @count % @buffer_size
+        @buffer[start..-1] + @buffer[0, start]
+      end
+    end
+
+    #
+    # Return the number of seconds since the monitor was created.
+    #
+    def elapsed
+      Process.clock_gettime(Process::CLOCK_MONOTONIC) - @started_at
+    end
+
+    def record(kind, mod, name, site) # :nodoc:
+      description = Looksee.adapter.describe_module(mod)
+      name = Module === name ? Looksee.adapter.describe_module(name) : name.to_s
+      backtrace = caller(3) if @count % @backtrace_every == 0
+      @mutex.synchronize do
+        @buffer[@count % @buffer_size] = Event.new(Time.now, kind, description, name, site, backtrace)
+        @count += 1
+        @module_counts[description] += 1
+        @site_counts[site] += 1
+      end
+    end
+
+    #
+    # Return the +limit+ modules with the most events, as [description,
+    # count] pairs.
+    #
+    def top_modules(limit=20)
+      top(module_counts, limit)
+    end
+
+    #
+    # Return the +limit+ call sites with the most events, as [site,
+    # count] pairs.
+    #
+    def top_sites(limit=20)
+      top(site_counts, limit)
+    end
+
+    #
+    # Write the counts and recent events to +io+ as newline-delimited
+    # JSON, and return +io+. Each line is one of:
+    #
+    #   {"type":"module","module":"Foo","count":12,"rate":0.4}
+    #   {"type":"site","site":"app/foo.rb:3","count":12,"rate":0.4}
+    #   {"type":"event","time":"...","kind":"added","module":"Foo",
+    #    "name":"bar","site":"app/foo.rb:3","backtrace":[...]}
+    #
+    # +rate+ is per second. +backtrace+ is null unless sampled.
+    #
+    def to_ndjson(io='')
+      seconds = elapsed
+      modules, sites, recent = module_counts, site_counts, events
+      require 'json'
+      modules.each do |description, count|
+        io << JSON.generate('type' => 'module', 'module' => description, 'count' => count, 'rate' => count / seconds) << "\n"
+      end
+      sites.each do |site, count|
+        io << JSON.generate('type' => 'site', 'site' => site, 'count' => count, 'rate' => count / seconds) << "\n"
+      end
+      recent.each do |event|
+        io << JSON.generate(
+          'type' => 'event', 'time' => event.time.utc.strftime('%Y-%m-%dT%H:%M:%S.%6NZ'),
+          'kind' => event.kind.to_s, 'module' => event.module, 'name' => event.name,
+          'site' => event.site, 'backtrace' => event.backtrace,
+        ) << "\n"
+      end
+      io
+    end
+
+    #
+    # Show the modules and call sites with the most events, with their
+    # rates per second.
+    #
+    def inspect
+      seconds = elapsed
+      lines = ["#{count} events in #{'%.1f' % seconds}s"]
+      [['Modules', top_modules], ['Call sites', top_sites]].each do |title, rows|
+        next if rows.empty?
+        lines << title
+        width = rows.map { |_, n| n.to_s.size }.max
+        rows.each do |label, n|
+          lines << "  #{n.to_s.rjust(width)}  #{'%.2f' % (n / seconds)}/s  #{label}"
+        end
+      end
+      lines.join("\n")
+    end
+
+    private
+
+    def top(counts, limit)
+      counts.sort_by { |label, n| [-n, label] }.first(limit)
+    end
+  end
+end
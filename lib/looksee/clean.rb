@@ -10,21 +10,34 @@ module Looksee
 
   autoload :VERSION, 'looksee/version'
   autoload :Adapter, 'looksee/adapter'
+  autoload :Census, 'looksee/census'
+  autoload :Churn, 'looksee/churn'
   autoload :Columnizer, 'looksee/columnizer'
   autoload :Editor, 'looksee/editor'
   autoload :Help, 'looksee/help'
+  autoload :Index, 'looksee/index'
   autoload :Inspector, 'looksee/inspector'
   autoload :LookupPath, 'looksee/lookup_path'
+  autoload :MemoryReport, 'looksee/memory_report'
+  autoload :MethodCache, 'looksee/method_cache'
+  autoload :MethodMetadata, 'looksee/method_metadata'
   autoload :PrettyPrintHack, 'looksee/pretty_print_hack'
+  autoload :Resolution, 'looksee/resolution'
+  autoload :Snapshot, 'looksee/snapshot'
+  autoload :SourceLocations, 'looksee/source_locations'
+  autoload :SurfaceDiff, 'looksee/surface_diff'
 
   class << self
     #
     # The default options passed to #look.
     #
+    # Like the other settings, the list is frozen when assigned. Assign
+    # a new list to change it.
+    #
     # Default: <tt>[:public, :protected, :private, :undefined,
     # :overridden]</tt>
     #
-    attr_accessor :default_specifiers
+    attr_reader :default_specifiers
 
     #
     # The width to use for displaying output, when not available in
@@ -32,7 +45,7 @@ module Looksee
     #
     # Default: 80
     #
-    attr_accessor :default_width
+    attr_reader :default_width
 
     #
     # The default styles to use for the +inspect+ strings.
@@ -45,9 +58,17 @@ module Looksee
     # * :private
     # * :undefined
     # * :overridden
+    # * :constant
+    # * :autoload
+    # * :hot
     #
     # The values are format strings.  They should all contain a single
-    # "%s", which is where the name is inserted.
+    # "%s", which is where the name is inserted. The :hot style is
+    # applied around the visibility style of a method.
+    #
+    # Like the other settings, the hash is frozen when assigned, so
+    # that it can be read from any Ractor. Assign a new hash to change
+    # it.
     #
     # Default:
     #
@@ -58,9 +79,12 @@ module Looksee
     #         :private    => "\e[1;31m%s\e[0m", # red
     #         :undefined  => "\e[1;34m%s\e[0m", # blue
     #         :overridden => "\e[1;30m%s\e[0m", # black
+    #         :constant   => "\e[1;36m%s\e[0m", # cyan
+    #         :autoload   => "\e[1;35m%s\e[0m", # magenta
+    #         :hot        => "\e[4m%s\e[0m",    # underlined
     #       }
     #
-    attr_accessor :styles
+    attr_reader :styles
 
     #
     # The editor command, used for Object#edit.
@@ -76,7 +100,7 @@ module Looksee
     # textmate, we also append options to position the cursor on the
     # appropriate line. If EDITOR is not set, we use "vi +%l %f".
     #
-    attr_accessor :editor
+    attr_reader :editor
 
     #
     # The interpreter adapter.
@@ -85,10 +109,71 @@ module Looksee
     #
     attr_accessor :adapter
 
+    #
+    # The cache of scanned method tables, shared by all lookup paths.
+    #
+    # Set to a new MethodCache to change its size, or to nil to disable
+    # caching.
+    #
+    # A cache cannot be shared between Ractors, so each non-main Ractor
+    # gets its own, of the default size.
+    #
+    # Default: a MethodCache holding up to 100,000 methods
+    #
+    def method_cache
+      if main_ractor?
+        @method_cache
+      else
+        Ractor.current[:looksee_method_cache] ||= MethodCache.new(MethodCache::DEFAULT_MAX_SIZE)
+      end
+    end
+
+    attr_writer :method_cache
+
     #
     # Wrapper around RUBY_ENGINE that's always defined.
     #
-    attr_accessor :ruby_engine
+    attr_reader :ruby_engine
+
+    #
+    # Whether +pp+ to standard output shows an Inspector by writing it
+    # straight there, one module at a time, when standard output is a
+    # terminal and the Inspector is not nested in another object.
+    # Otherwise, as for IRB results, the whole output is built as a
+    # string first. See Inspector#each_chunk.
+    #
+    # Default: true
+    #
+    attr_reader :stream
+
+    #
+    # The pager command, used for Inspector#page_output and the +:page+
+    # specifier. Output is fed to it through a pipe.
+    #
+    # Default: the PAGER environment variable if set, otherwise "less -R"
+    #
+    attr_reader :pager
+
+    [:default_specifiers, :default_width, :styles, :editor, :ruby_engine, :stream, :pager].each do |name|
+      define_method("#{name}=") do |value|
+        instance_variable_set("@#{name}", shareable(value))
+      end
+    end
+
+    #
+    # Return +object+, deeply frozen so that it can be passed between
+    # Ractors without copying. Does nothing where there are no Ractors.
+    #
+    def shareable(object)
+      defined?(Ractor) ? Ractor.make_shareable(object) : object
+    end
+
+    #
+    # Return false if called from a Ractor other than the main one.
+    #
+    def main_ractor?
+      !defined?(Ractor) || Ractor.current == Ractor.main
+    end
 
     #
     # Return a Looksee::Inspector for the given +object+.
@@ -105,20 +190,65 @@ module Looksee
     #   * +:noprivate+ - include public methods
     #   * +:noundefined+ - include public methods (see Module#undef_method)
     #   * +:nooverridden+ - include public methods
+    #   * +:constants+ - also show constants, without triggering
+    #     autoloads (private constants are shown with +:private+)
+    #   * +:noconstants+ - do not show constants
+    #   * +:memsize+ - show the memory used by each module's method
+    #     table and method caches, where available
+    #   * +:nomemsize+ - do not show memory usage
+    #   * +:hot+ - highlight methods which have been called on the
+    #     object's class, with the number of call cache entries for
+    #     each, where available
+    #   * +:nohot+ - do not highlight called methods
+    #   * +:census+ - show the number of live instances of each class,
+    #     of those with singleton classes, and of objects each module
+    #     extends (see Census)
+    #   * +:nocensus+ - do not show object counts
+    #   * +:page+ - in IRB, show the output through Looksee.pager,
+    #     rendering only as much as the pager reads (every method
+    #     table is still scanned up front to find overridden methods,
+    #     unless they are styled like the rest)
+    #   * +:nopage+ - do not use the pager
     #   * a string - only include methods containing this string (may
     #     be used multiple times)
     #   * a regexp - only include methods matching this regexp (may
     #     be used multiple times)
+    #   * a module - show the lookup path as if <tt>using</tt> this
+    #     module (may be used multiple times, in +using+ order)
     #
     # The default (if options is nil or omitted) is given by
     # #default_lookup_path_options.
     #
     def [](object, *args)
+      options = parse_specifiers(args)
+      lookup_path = LookupPath.new(object, :using => options.delete(:using))
+      Inspector.new(lookup_path, options)
+    end
+
+    #
+    # Return the Inspector options for the given specifiers, on top of
+    # #default_specifiers, with the modules to activate refinements from
+    # under :using. See #[].
+    #
+    def parse_specifiers(args) # :nodoc:
       options = {:visibilities => Set[], :filters => Set[]}
+      using = []
       (Looksee.default_specifiers + args).each do |arg|
         case arg
         when String, Regexp
           options[:filters] << arg
+        when :constants, :noconstants
+          options[:constants] = (arg == :constants)
+        when :memsize, :nomemsize
+          options[:memsize] = (arg == :memsize)
+        when :hot, :nohot
+          options[:hot] = (arg == :hot)
+        when :census, :nocensus
+          options[:census] = (arg == :census)
+        when :page, :nopage
+          options[:page] = (arg == :page)
+        when Module
+          using << arg
         when :public, :protected, :private, :undefined, :overridden
           options[:visibilities].add(arg)
         when :nopublic, :noprotected, :noprivate, :noundefined, :nooverridden
@@ -128,8 +258,61 @@ module Looksee
           raise ArgumentError, "invalid specifier: #{arg.inspect}"
         end
       end
-      lookup_path = LookupPath.new(object)
-      Inspector.new(lookup_path, options)
+      options[:using] = using
+      options
+    end
+
+    #
+    # Return the tree of modules below +mod+ which define the method
+    # +name+, overriding the one in +mod+ (if any) for objects further
+    # down the hierarchy.
+    #
+    # Each node is an array of <tt>[module, visibility, children]</tt>,
+    # where +children+ are the nodes for the nearest overriding modules
+    # below +module+. Modules included into descendants count if they
+    # define the method.
+    #
+    #   Looksee.overrides_below(ApplicationRecord, :save)
+    #   # => [[Post, :public, []], [User, :public, [[Admin, :private, []]]]]
+    #
+    def overrides_below(mod, name)
+      adapter.overrides_below(mod, name)
+    end
+
+    #
+    # Return a MemoryReport ranking the modules in the heap by the
+    # memory used by their method tables and method caches, showing
+    # the top +limit+ (all if nil).
+    #
+    #   Looksee.memory_report(10)
+    #
+    def memory_report(limit=20)
+      MemoryReport.build(:limit => limit)
+    end
+
+    #
+    # Return a Census of the objects in the heap, which ranks classes by
+    # their instances and instances with singleton classes, and modules
+    # by the objects they extend.
+    #
+    def census
+      Census.build
+    end
+
+    #
+    # Return a Resolution of the named method for +object+: the module
+    # it is found in, and every module defining it, in the order +super+
+    # would call them. No lookup path is built.
+    #
+    def resolve(object, name)
+      Resolution.new(name, adapter.resolve(object, name))
+    end
+
+    #
+    # Return the SurfaceDiff between two Snapshots, or paths to them.
+    #
+    def diff_surface(a, b)
+      SurfaceDiff.build(a, b)
     end
 
     #
@@ -154,8 +337,14 @@ module Looksee
     :private    => "\e[1;31m%s\e[0m", # red
     :undefined  => "\e[1;34m%s\e[0m", # blue
     :overridden => "\e[1;30m%s\e[0m", # black
+    :constant   => "\e[1;36m%s\e[0m", # cyan
+    :autoload   => "\e[1;35m%s\e[0m", # magenta
+    :hot        => "\e[4m%s\e[0m",    # underlined
   }
   self.editor = ENV['LOOKSEE_EDITOR'] || ENV['EDITOR'] || 'vi'
+  self.stream = true
+  self.pager = ENV['PAGER'] || 'less -R'
+  self.method_cache = MethodCache.new(MethodCache::DEFAULT_MAX_SIZE)
 
   if Object.const_defined?(:RUBY_ENGINE)
     self.ruby_engine = RUBY_ENGINE
@@ -167,6 +356,19 @@ module Looksee
   when 'jruby'
     self.adapter = Adapter::JRuby.new
   else
-    self.adapter = Adapter::MRI.new
+    self.adapter = shareable(Adapter::MRI.new)
+  end
+
+  # Autoloads cannot be triggered from non-main Ractors, so where these
+  # are supported, load up front what #[] and the shareable heap-wide
+  # results need. The rest stays autoloaded.
+  RACTOR_CONSTANTS = [ # :nodoc:
+    :Adapter, :Census, :Columnizer, :Index, :Inspector, :LookupPath,
+    :MemoryReport, :MethodCache, :MethodMetadata, :PrettyPrintHack,
+    :Resolution, :SourceLocations,
+  ].freeze
+
+  if defined?(Ractor) && RUBY_VERSION >= '3.1'
+    RACTOR_CONSTANTS.each { |name| const_get(name) }
   end
 end
@@ -1,71 +1,155 @@
 module Looksee
   module Columnizer
+    #
+    # The code points displayed two columns wide in a terminal: the
+    # East Asian Wide (W) and Fullwidth (F) ranges of Unicode 15, as a
+    # flat, sorted list of inclusive [first, last] pairs.
+    #
+    WIDE_RANGES = [
+      0x1100, 0x115F, 0x231A, 0x231B, 0x2329, 0x232A, 0x23E9, 0x23EC,
+      0x23F0, 0x23F0, 0x23F3, 0x23F3, 0x25FD, 0x25FE, 0x2614, 0x2615,
+      0x2648, 0x2653, 0x267F, 0x267F, 0x2693, 0x2693, 0x26A1, 0x26A1,
+      0x26AA, 0x26AB, 0x26BD, 0x26BE, 0x26C4, 0x26C5, 0x26CE, 0x26CE,
+      0x26D4, 0x26D4, 0x26EA, 0x26EA, 0x26F2, 0x26F3, 0x26F5, 0x26F5,
+      0x26FA, 0x26FA, 0x26FD, 0x26FD, 0x2705, 0x2705, 0x270A, 0x270B,
+      0x2728, 0x2728, 0x274C, 0x274C, 0x274E, 0x274E, 0x2753, 0x2755,
+      0x2757, 0x2757, 0x2795, 0x2797, 0x27B0, 0x27B0, 0x27BF, 0x27BF,
+      0x2B1B, 0x2B1C, 0x2B50, 0x2B50, 0x2B55, 0x2B55, 0x2E80, 0x2E99,
+      0x2E9B, 0x2EF3, 0x2F00, 0x2FD5, 0x2FF0, 0x2FFB, 0x3000, 0x303E,
+      0x3041, 0x3096, 0x3099, 0x30FF, 0x3105, 0x312F, 0x3131, 0x318E,
+      0x3190, 0x31E3, 0x31F0, 0x321E, 0x3220, 0x3247, 0x3250, 0x4DBF,
+      0x4E00, 0xA48C, 0xA490, 0xA4C6, 0xA960, 0xA97C, 0xAC00, 0xD7A3,
+      0xF900, 0xFAFF, 0xFE10, 0xFE19, 0xFE30, 0xFE52, 0xFE54, 0xFE66,
+      0xFE68, 0xFE6B, 0xFF01, 0xFF60, 0xFFE0, 0xFFE6, 0x16FE0, 0x16FE4,
+      0x16FF0, 0x16FF1, 0x17000, 0x187F7, 0x18800, 0x18CD5, 0x18D00, 0x18D08,
+      0x1AFF0, 0x1AFF3, 0x1AFF5, 0x1AFFB, 0x1AFFD, 0x1AFFE, 0x1B000, 0x1B122,
+      0x1B132, 0x1B132, 0x1B150, 0x1B152, 0x1B155, 0x1B155, 0x1B164, 0x1B167,
+      0x1B170, 0x1B2FB, 0x1F004, 0x1F004, 0x1F0CF, 0x1F0CF, 0x1F18E, 0x1F18E,
+      0x1F191, 0x1F19A, 0x1F200, 0x1F202, 0x1F210, 0x1F23B, 0x1F240, 0x1F248,
+      0x1F250, 0x1F251, 0x1F260, 0x1F265, 0x1F300, 0x1F320, 0x1F32D, 0x1F335,
+      0x1F337, 0x1F37C, 0x1F37E, 0x1F393, 0x1F3A0, 0x1F3CA, 0x1F3CF, 0x1F3D3,
+      0x1F3E0, 0x1F3F0, 0x1F3F4, 0x1F3F4, 0x1F3F8, 0x1F43E, 0x1F440, 0x1F440,
+      0x1F442, 0x1F4FC, 0x1F4FF, 0x1F53D, 0x1F54B, 0x1F54E, 0x1F550, 0x1F567,
+      0x1F57A, 0x1F57A, 0x1F595, 0x1F596, 0x1F5A4, 0x1F5A4, 0x1F5FB, 0x1F64F,
+      0x1F680, 0x1F6C5, 0x1F6CC, 0x1F6CC, 0x1F6D0, 0x1F6D2, 0x1F6D5, 0x1F6D7,
+      0x1F6DC, 0x1F6DF, 0x1F6EB, 0x1F6EC, 0x1F6F4, 0x1F6FC, 0x1F7E0, 0x1F7EB,
+      0x1F7F0, 0x1F7F0, 0x1F90C, 0x1F93A, 0x1F93C, 0x1F945, 0x1F947, 0x1F9FF,
+      0x1FA70, 0x1FA7C, 0x1FA80, 0x1FA88, 0x1FA90, 0x1FABD, 0x1FABF, 0x1FAC5,
+      0x1FACE, 0x1FADB, 0x1FAE0, 0x1FAE8, 0x1FAF0, 0x1FAF8, 0x20000, 0x2FFFD,
+      0x30000, 0x3FFFD,
+    ].freeze
+
+    #
+    # Matches a grapheme cluster which takes up no columns, such as a
+    # lone zero width space or combining mark.
+    #
+    ZERO_WIDTH = /\A[\p{Mn}\p{Me}\p{Cf}]+\z/
+
+    #
+    # Emoji presentation selector, which makes the preceding character
+    # two columns wide.
+    #
+    EMOJI_PRESENTATION = "\u{FE0F}".freeze
+
     class << self
       #
       # Arrange the given strings in columns, restricted to the given
       # width.  Smart enough to ignore content in terminal control
       # sequences.
       #
+      # Strings fill columns top to bottom, as many columns as fit. The
+      # display width of each string is measured once up front, and
+      # candidate layouts are sized from those measurements alone.
+      #
       def columnize(strings, width)
         return '' if strings.empty?
 
+        widths = strings.map { |string| display_width(string) }
         num_columns = 1
-        layout = [strings]
         loop do
-          break if layout.first.length <= 1
-          next_layout = layout_in_columns(strings, num_columns + 1)
-          break if layout_width(next_layout) > width
-          layout = next_layout
+          break if column_height(strings.length, num_columns) <= 1
+          break if too_wide?(widths, num_columns + 1, width)
           num_columns += 1
         end
 
-        pad_strings(layout)
-        rectangularize_layout(layout)
-        layout.transpose.map do |row|
-          '  ' + row.compact.join('  ')
+        height = column_height(strings.length, num_columns)
+        column_widths = layout_column_widths(widths, num_columns)
+        pad_strings(strings, widths, column_widths, height)
+        (0...height).map do |row|
+          cells = []
+          row.step(strings.length - 1, height) { |i| cells << strings[i] }
+          '  ' + cells.join('  ')
         end.join("\n") << "\n"
       end
 
       private  # -----------------------------------------------------
 
-      def layout_in_columns(strings, num_columns)
-        strings_per_column = (strings.length / num_columns.to_f).ceil
-        (0...num_columns).map{|i| strings[i*strings_per_column...(i+1)*strings_per_column] || []}
+      def column_height(num_strings, num_columns)
+        (num_strings + num_columns - 1) / num_columns
       end
 
-      def layout_width(layout)
-        widths = layout_column_widths(layout)
-        widths.inject(0){|sum, w| sum + w} + 2*layout.length
+      #
+      # Return true if the layout in the given number of columns is
+      # wider than +width+. Stops measuring as soon as it is.
+      #
+      def too_wide?(widths, num_columns, width)
+        height = column_height(widths.length, num_columns)
+        total = 2*num_columns
+        (0...num_columns).each do |i|
+          column = widths[i*height, height] or
+            break
+          total += column.max || 0
+          return true if total > width
+        end
+        total > width
       end
 
-      def layout_column_widths(layout)
-        layout.map do |column|
-          column.map{|string| display_width(string)}.max || 0
+      def layout_column_widths(widths, num_columns)
+        height = column_height(widths.length, num_columns)
+        (0...num_columns).map do |i|
+          column = widths[i*height, height]
+          (column && column.max) || 0
         end
       end
 
+      #
+      # Return the number of terminal columns +string+ takes up, ignoring
+      # terminal control sequences.
+      #
+      # ASCII strings, which most method names are, take one column per
+      # character. Others are measured per grapheme cluster, so combining
+      # marks add nothing, and East Asian wide characters and emoji take
+      # two columns.
+      #
       def display_width(string)
         # remove terminal control sequences
-        string.gsub(/\e\[.*?m/, '').length
+        string = string.gsub(/\e\[.*?m/, '')
+        return string.length if string.ascii_only? || !measurable?(string)
+        width = 0
+        string.each_grapheme_cluster { |cluster| width += cluster_width(cluster) }
+        width
       end
 
-      def pad_strings(layout)
-        widths = layout_column_widths(layout)
-        layout.each_with_index do |column, i|
-          column_width = widths[i]
-          column.each do |string|
-            padding = column_width - display_width(string)
-            string << ' '*padding
-          end
-        end
+      def measurable?(string)
+        string.encoding == Encoding::UTF_8 && string.valid_encoding?
+      end
+
+      def cluster_width(cluster)
+        return 0 if cluster.match?(ZERO_WIDTH)
+        return 2 if wide?(cluster.ord) || cluster.include?(EMOJI_PRESENTATION)
+        1
+      end
+
+      def wide?(code_point)
+        i = (0...WIDE_RANGES.length/2).bsearch { |j| WIDE_RANGES[2*j + 1] >= code_point } or
+          return false
+        WIDE_RANGES[2*i] <= code_point
       end
 
-      def rectangularize_layout(layout)
-        return if layout.length == 1
-        height = layout[0].length
-        layout[1..-1].each do |column|
-          column.length == height or
-            column[height - 1] = nil
+      def pad_strings(strings, widths, column_widths, height)
+        strings.each_with_index do |string, i|
+          padding = column_widths[i / height] - widths[i]
+          string << ' '*padding
         end
       end
     end
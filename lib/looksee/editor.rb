@@ -13,11 +13,12 @@ module Looksee
     # Run the editor command for the +method_name+ of +object+.
     #
     def edit(object, method_name)
-      method = LookupPath.new(object).find(method_name.to_s) or
+      name = method_name.to_s
+      owner = Looksee.resolve(object, name).owner or
         raise NoMethodError, "no method `#{method_name}' in lookup path of #{object.class} instance"
-      file, line = method.source_location
+      file, line = source_location(owner, name)
       if !file
-        raise NoSourceLocationError, "no source location for #{method.owner}##{method.name}"
+        raise NoSourceLocationError, "no source location for #{owner}##{name}"
       elsif !File.exist?(file)
         raise NoSourceFileError, "cannot find source file: #{file}"
       else
@@ -50,6 +51,10 @@ module Looksee
 
     private
 
+    def source_location(mod, name)
+      Looksee.safe_call(Module, :instance_method, mod, name).source_location
+    end
+
     def infer_arguments
       return if command =~ /%[fl]/
 
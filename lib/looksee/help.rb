@@ -20,12 +20,30 @@ module Looksee
         |      :noprotected  :noundefined
         |        Do not print methods with these visibilities.
         |
+        |      :constants  :noconstants
+        |        Print constants, or not. Autoloads are not triggered.
+        |
+        |      :memsize  :nomemsize
+        |        Print the memory used by method tables and caches, or not.
+        |
+        |      :hot  :nohot
+        |        Highlight methods called on the object's class, or not.
+        |
+        |      :census  :nocensus
+        |        Print counts of live instances and singleton classes, or not.
+        |
+        |      :page  :nopage
+        |        Show the output through Looksee.pager, or not.
+        |
         |      "string"
         |        Print methods containing this string.
         |
         |      /regexp/
         |        Print methods matching this regexp.
         |
+        |      SomeModule
+        |        Show methods as if \`using SomeModule'.
+        |
         |    Styles:
         |
         |      #{Looksee.styles[:module] % 'Module'}
@@ -34,6 +52,9 @@ module Looksee
         |      #{Looksee.styles[:private] % 'private'}    }
         |      #{Looksee.styles[:undefined] % 'undefined'}  ] like a ghost!
         |      #{Looksee.styles[:overridden] % 'overridden'} ] like a shadow!
+        |      #{Looksee.styles[:constant] % '::Constant'}
+        |      #{Looksee.styles[:autoload] % '::Autoload (path)'}
+        |      #{Looksee.styles[:hot] % 'hot (call caches)'}
         |
         |      Customize with Looksee.styles:
         |
@@ -43,6 +64,26 @@ module Looksee
         |          ...
         |        }
         |
+        |  \e[1mLooksee.memory_report(limit=20)\e[0m
+        |
+        |    Rank the modules in the heap by the memory used by their
+        |    method tables and method caches.
+        |
+        |  \e[1mLooksee.census\e[0m
+        |
+        |    Rank classes by live instances and instances with singleton
+        |    classes, and modules by the objects they extend.
+        |
+        |  \e[1mLooksee.resolve(object, method)\e[0m
+        |
+        |    Show the module the method is found in, and every module
+        |    defining it, in the order super would call them.
+        |
+        |  \e[1mLooksee.diff_surface(a, b)\e[0m
+        |
+        |    List the methods added, removed, changed visibility or
+        |    moved owner between two snapshots (see Looksee::Snapshot).
+        |
         |  \e[1mobject.look.edit(method)\e[0m
         |
         |    Jump to the source of the given method. Set your editor
@@ -0,0 +1,83 @@
+module Looksee
+  #
+  # An index of every method defined in every module in the heap, by
+  # name.
+  #
+  #   index = Looksee::Index.build
+  #   index.owners(:call)  # => [Proc, Method, ...]
+  #
+  class Index
+    #
+    # Build an index of the methods of all modules currently in the
+    # heap. The index is frozen, so it can be passed between Ractors.
+    #
+    def self.build
+      Looksee.shareable(new(Looksee.adapter.method_index))
+    end
+
+    #
+    # Create an index from a hash of method names (as Symbols) to flat
+    # arrays of [module, visibility, module, visibility, ...].
+    #
+    def initialize(table)
+      @table = table
+    end
+
+    #
+    # Return the modules which define the named method, including those
+    # which undefine it.
+    #
+    def owners(name)
+      entries = @table[name.to_sym] or
+        return []
+      result = []
+      entries.each_slice(2) { |mod, _| result << mod }
+      result
+    end
+
+    #
+    # Return a hash of the modules which define the named method to the
+    # method's visibility in each (:public, :protected, :private, or
+    # :undefined).
+    #
+    def [](name)
+      entries = @table[name.to_sym] or
+        return {}
+      result = {}
+      entries.each_slice(2) { |mod, visibility| result[mod] = visibility }
+      result
+    end
+
+    #
+    # Return true if any module defines the named method.
+    #
+    def include?(name)
+      @table.key?(name.to_sym)
+    end
+
+    #
+    # Return the names of all indexed methods, as Symbols.
+    #
+    def names
+      @table.keys
+    end
+
+    #
+    # Return the number of distinct method names indexed.
+    #
+    def size
+      @table.size
+    end
+
+    #
+    # Return the approximate number of bytes used by the index, as
+    # reported by ObjectSpace.memsize_of. Modules are not counted.
+    #
+    def memsize
+      require 'objspace'
+      @table.each_value.inject(ObjectSpace.memsize_of(@table)) do |sum, entries|
+        sum + ObjectSpace.memsize_of(entries)
+      end
+    end
+  end
+end
@@ -6,6 +6,12 @@ module Looksee
       @lookup_path = lookup_path
       @visibilities = (vs = options[:visibilities]) ? vs.to_set : Set[]
       @filters = (fs = options[:filters]) ? fs.to_set : Set[]
+      @filter_pattern = compile_filters(@filters)
+      @constants = options[:constants] || false
+      @memsize = options[:memsize] || false
+      @hot = options[:hot] || false
+      @census = options[:census] || false
+      @page = options[:page] || false
       @width = options[:width] || ENV['COLUMNS'].to_i.nonzero? || Looksee.default_width
     end
 
@@ -13,13 +19,89 @@ module Looksee
     attr_reader :visibilities
     attr_reader :filters
 
+    #
+    # True if constants are shown.
+    #
+    attr_reader :constants
+
+    #
+    # True if the memory used by method tables and caches is shown.
+    #
+    attr_reader :memsize
+
+    #
+    # True if methods with populated call caches are highlighted.
+    #
+    attr_reader :hot
+
+    #
+    # True if object counts from a Census are shown.
+    #
+    attr_reader :census
+
+    #
+    # True if IRB and +pp+ show the output through Looksee.pager. See
+    # #page.
+    #
+    attr_reader :page
+
     #
     # Print the method lookup path of self. See the README for details.
     #
     def inspect
-      lookup_path.entries.reverse.map do |entry|
-        inspect_entry(entry)
-      end.join("\n")
+      string = +''
+      each_chunk { |chunk| string << chunk }
+      string
+    end
+
+    #
+    # Yield the output of #inspect in pieces, as each module's is ready,
+    # so it can be shown before the rest is built. Return an Enumerator
+    # if no block is given.
+    #
+    def each_chunk
+      return enum_for(:each_chunk) if !block_given?
+      call_cache_counts = (@hot && Looksee.adapter.call_cache_counts(lookup_path.object)) || {}
+      census = Census.build if @census
+      first = true
+      lookup_path.entries.reverse_each do |entry|
+        yield "\n" if !first
+        first = false
+        yield inspect_entry(entry, call_cache_counts[entry.module] || {}, census)
+      end
+    end
+
+    #
+    # Write the output of #inspect to +io+ followed by a newline, one
+    # module at a time, flushing after each. Return +io+.
+    #
+    def write(io)
+      each_chunk do |chunk|
+        io.write(chunk)
+        io.flush if io.respond_to?(:flush)
+      end
+      io.write("\n")
+      io
+    end
+
+    #
+    # Show the output of #inspect through the given pager command, one
+    # module at a time. When the pager quits before reading everything,
+    # the remaining modules are not rendered. Return nil.
+    #
+    def page_output(command=Looksee.pager)
+      IO.popen(command, 'w') { |io| write(io) }
+      nil
+    rescue Errno::EPIPE
+      nil
+    end
+
+    def pretty_print(pp)
+      if @page && PrettyPrintHack.terminal_output?(pp)
+        page_output
+      else
+        super
+      end
     end
 
     #
@@ -36,37 +118,81 @@ module Looksee
 
     private
 
-    def inspect_entry(entry)
-      string = styled_module_name(entry) << "\n"
-      string << Columnizer.columnize(styled_methods(entry), @width)
+    def inspect_entry(entry, call_cache_counts, census)
+      string = styled_module_name(entry)
+      string << memsize_annotation(entry) if @memsize
+      string << census_annotation(entry, census) if census
+      string << "\n"
+      string << Columnizer.columnize(styled_methods(entry, call_cache_counts), @width)
+      string << Columnizer.columnize(styled_constants(entry), @width) if @constants
       string.chomp
     end
 
     def styled_module_name(entry)
-      Looksee.styles[:module] % Looksee.adapter.describe_module(entry.module)
+      Looksee.styles[:module] % entry.description
+    end
+
+    def memsize_annotation(entry)
+      usage = Looksee.adapter.method_table_usage(entry.module) or
+        return ''
+      '  ' + MemoryReport.describe_usage(usage)
+    end
+
+    def census_annotation(entry, census)
+      description = census.describe(entry.module)
+      description.empty? ? '' : '  ' + description
     end
 
-    def styled_methods(entry)
-      pattern = filter_pattern
+    def styled_methods(entry, call_cache_counts)
+      styles = Looksee.styles
       show_overridden = @visibilities.include?(:overridden)
       entry.map do |name, visibility|
         next if !selected?(name, visibility)
-        style = entry.overridden?(name) ? :overridden : visibility
-        next if style == :overridden && !show_overridden
-        Looksee.styles[style] % name
+        # Telling if a method is overridden scans the modules before
+        # this one, so skip it if it would make no difference.
+        if (!show_overridden || styles[:overridden] != styles[visibility]) && entry.overridden?(name)
+          next if !show_overridden
+          style = :overridden
+        else
+          style = visibility
+        end
+        if (count = call_cache_counts[name])
+          styles[:hot] % (styles[style] % "#{name} (#{count})")
+        else
+          styles[style] % name
+        end
+      end.compact
+    end
+
+    def styled_constants(entry)
+      entry.constants.sort.map do |name, (visibility, _, autoload)|
+        next if !filtered?(name)
+        if autoload
+          Looksee.styles[:autoload] % "::#{name} (#{autoload})"
+        elsif visibility == :private
+          next if !@visibilities.include?(:private)
+          Looksee.styles[:private] % "::#{name}"
+        else
+          Looksee.styles[:constant] % "::#{name}"
+        end
       end.compact
     end
 
-    def filter_pattern
-      strings = filters.grep(String)
-      regexps = filters.grep(Regexp)
-      string_patterns = strings.map{|s| Regexp.escape(s)}
-      regexp_patterns = regexps.map{|s| s.source}
-      /#{(string_patterns + regexp_patterns).join('|')}/
+    #
+    # Compile the filters into a single Regexp, or nil if there are
+    # none. Strings match as substrings, and regexps keep their flags.
+    #
+    def compile_filters(filters)
+      return nil if filters.empty?
+      Regexp.union(filters.to_a)
+    end
+
+    def filtered?(name)
+      @filter_pattern.nil? || name.match?(@filter_pattern)
     end
 
     def selected?(name, visibility)
-      @visibilities.include?(visibility) && name =~ filter_pattern
+      @visibilities.include?(visibility) && filtered?(name)
     end
   end
 end
@@ -4,8 +4,19 @@ module Looksee
   # Entries.
   #
   class LookupPath
-    def initialize(object)
+    #
+    # Create the lookup path of +object+.
+    #
+    # Options:
+    #
+    #   * +:using+ - a list of modules containing refinements, in the
+    #     order they would be activated with +using+. Where these refine
+    #     a module in the lookup path, the refinement is shown just
+    #     before the module, as refined methods are found there first.
+    #
+    def initialize(object, options={})
       @object = object
+      @using = options[:using] || []
       @entries = create_entries
     end
 
@@ -14,6 +25,11 @@ module Looksee
     #
     attr_reader :object
 
+    #
+    # The modules whose refinements are active in this lookup path.
+    #
+    attr_reader :using
+
     #
     # List of Entry objects, each one representing a Module in the
     # lookup path.
@@ -21,17 +37,23 @@ module Looksee
     attr_reader :entries
 
     def find(name)
-      entries.each do |entry|
-        visibility = entry.methods[name] or
-          next
+      entry = find_entry(name) or
+        return nil
+      Looksee.safe_call(Module, :instance_method, entry.module, name)
+    end
 
-        if visibility == :undefined
-          return nil
-        else
-          return Looksee.safe_call(Module, :instance_method, entry.module, name)
-        end
-      end
-      nil
+    #
+    # Return the Entry for the module in which the named method is
+    # found, or nil if it is not found or has been undefined.
+    #
+    # Only the entries up to the one found are scanned.
+    #
+    def find_entry(name)
+      name = name.to_sym
+      index = @definitions.first(name) or
+        return nil
+      entry = entries[index]
+      entry.methods[name] == :undefined ? nil : entry
     end
 
     #
@@ -43,12 +65,27 @@ module Looksee
 
     private  # -------------------------------------------------------
 
+    #
+    # Create the entries, which scan their modules' methods when first
+    # asked for them. They share a Definitions, which tells which
+    # methods are overridden, and where each name resolves to.
+    #
     def create_entries
-      seen = Set.new
-      Looksee.adapter.lookup_modules(object).map do |mod|
-        entry = Entry.new(mod, seen)
-        seen += entry.methods.keys
-        entry
+      entries = []
+      @definitions = Definitions.new(entries)
+      modules.each_with_index do |mod, index|
+        entries << Entry.new(mod, @definitions, index)
+      end
+      entries
+    end
+
+    def modules
+      adapter = Looksee.adapter
+      modules = adapter.lookup_modules(object)
+      return modules if @using.empty?
+      modules.flat_map do |mod|
+        refinements = @using.reverse.map { |refiner| adapter.refinement_for(refiner, mod) }
+        refinements.compact << mod
       end
     end
 
@@ -56,25 +93,65 @@ module Looksee
     # An entry in the LookupPath.
     #
     class Entry
-      def initialize(mod, overridden)
+      #
+      # Create the entry for +mod+ at +index+ in a lookup path, whose
+      # entries share +definitions+.
+      #
+      def initialize(mod, definitions, index)
         @module = mod
-        @methods = find_methods
-        @overridden = overridden
+        @definitions = definitions
+        @index = index
       end
 
-      attr_reader :module, :methods
+      attr_reader :module
+
+      #
+      # Return a hash of the names of the methods defined directly in
+      # the module, as Symbols, to their visibilities.
+      #
+      # The module is scanned the first time this is called.
+      #
+      def methods
+        @methods ||= find_methods
+      end
+
+      #
+      # Return the label for the module in the Inspector output.
+      #
+      def description
+        Looksee.adapter.describe_module(@module)
+      end
 
+      #
+      # Return the constants defined directly in the module, as returned
+      # by the adapter's +constants+.
+      #
+      def constants
+        @constants ||= Looksee.adapter.constants(@module)
+      end
+
+      #
+      # Return the SourceLocations of the module's methods.
+      #
+      def source_locations
+        @source_locations ||= Looksee.adapter.source_locations(@module)
+      end
+
+      #
+      # Return true if the named method is defined by an earlier entry in
+      # the lookup path.
+      #
       def overridden?(name)
-        @overridden.include?(name.to_s)
+        @definitions.before?(name.to_sym, @index)
       end
 
       #
-      # Yield each method in alphabetical order along with its
-      # visibility (:public, :private, :protected, :undefined, or
-      # :overridden).
+      # Yield each method name, as a Symbol, in alphabetical order along
+      # with its visibility (:public, :private, :protected, or
+      # :undefined).
       #
       def each(&block)
-        @methods.sort.each(&block)
+        methods.sort.each(&block)
       end
 
       include Enumerable
@@ -82,17 +159,54 @@ module Looksee
       private  # -----------------------------------------------------
 
       def find_methods
-        methods = {}
-        [:public, :protected, :private].each do |visibility|
-          meths = Looksee.safe_call(Module, "#{visibility}_instance_methods", @module, false)
-          meths.each do |method|
-            methods[method.to_s] = visibility
-          end
+        if (cache = Looksee.method_cache)
+          cache.fetch(@module)
+        else
+          Looksee.adapter.instance_method_visibilities_by_symbol(@module)
         end
-        Looksee.adapter.undefined_instance_methods(@module).each do |method|
-          methods[method.to_s] = :undefined
+      end
+    end
+
+    #
+    # Records the index of the first entry defining each method name,
+    # scanning entries in lookup order only as far as has been needed.
+    #
+    class Definitions # :nodoc:
+      def initialize(entries)
+        @entries = entries
+        @first_definitions = {}
+        @num_scanned = 0
+      end
+
+      #
+      # Return the index of the first entry defining +name+, or nil if
+      # there is none.
+      #
+      def first(name)
+        until (index = @first_definitions[name]) || @num_scanned == @entries.size
+          scan_next
+        end
+        index
+      end
+
+      #
+      # Return true if an entry before +index+ defines +name+.
+      #
+      def before?(name, index)
+        scan_next while @num_scanned < index
+        first = @first_definitions[name] or
+          return false
+        first < index
+      end
+
+      private  # -----------------------------------------------------
+
+      def scan_next
+        index = @num_scanned
+        @entries[index].methods.each_key do |name|
+          @first_definitions[name] ||= index
         end
-        methods
+        @num_scanned += 1
       end
     end
   end
@@ -0,0 +1,91 @@
+module Looksee
+  #
+  # A ranking of modules by the memory used by their method tables and
+  # method caches, largest first.
+  #
+  #   report = Looksee::MemoryReport.build(:limit => 10)
+  #   report.rows.first.module  # => the module using the most
+  #
+  # Each table's usage is a triple of <tt>[memsize, size,
+  # capacity]</tt>, as returned by the adapter's
+  # +method_table_usage+. Only the tables themselves are counted, not
+  # the method entries or call caches they point to.
+  #
+  class MemoryReport
+    include PrettyPrintHack
+
+    TABLES = [:m_tbl, :callable_m_tbl, :cc_tbl].freeze
+
+    #
+    # A module and the usage of each of its tables.
+    #
+    Row = Struct.new(:module, :usage) do
+      #
+      # Return the total bytes used by the module's tables.
+      #
+      def memsize
+        TABLES.inject(0) { |sum, table| sum + usage[table][0] }
+      end
+    end
+
+    #
+    # Build a report of the modules currently in the heap.
+    #
+    # Options:
+    #
+    #   * +:modules+ - the modules to report on, instead of the heap
+    #   * +:limit+ - only keep the largest +limit+ rows
+    #
+    # Modules for which the adapter cannot determine usage are left
+    # out.
+    #
+    def self.build(options={})
+      modules = options[:modules] || ObjectSpace.each_object(Module)
+      rows = []
+      modules.each do |mod|
+        usage = Looksee.adapter.method_table_usage(mod) or
+          next
+        rows << Row.new(mod, usage)
+      end
+      rows = rows.sort_by { |row| -row.memsize }
+      rows = rows.first(options[:limit]) if options[:limit]
+      Looksee.shareable(new(rows))
+    end
+
+    #
+    # Return a description of a module's table usage, like:
+    #
+    #   m_tbl 2072B 50/128  callable_m_tbl 0B 0/0  cc_tbl 152B 4/8
+    #
+    def self.describe_usage(usage)
+      TABLES.map do |table|
+        memsize, size, capacity = usage[table]
+        "#{table} #{memsize}B #{size}/#{capacity}"
+      end.join('  ')
+    end
+
+    def initialize(rows)
+      @rows = rows
+    end
+
+    #
+    # The Rows of the report, largest first.
+    #
+    attr_reader :rows
+
+    #
+    # Return the total bytes used by the tables of all reported modules.
+    #
+    def memsize
+      rows.inject(0) { |sum, row| sum + row.memsize }
+    end
+
+    def inspect
+      width = rows.map { |row| row.memsize.to_s.size }.max || 0
+      rows.map do |row|
+        name = Looksee.styles[:module] % Looksee.adapter.describe_module(row.module)
+        "#{row.memsize.to_s.rjust(width)}B  #{name}  #{self.class.describe_usage(row.usage)}"
+      end.join("\n")
+    end
+  end
+end
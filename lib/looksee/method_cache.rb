@@ -0,0 +1,86 @@
+module Looksee
+  #
+  # Caches the methods found in each module's method table, so that
+  # modules which have not changed since they were last looked at are
+  # not scanned again.
+  #
+  # Each cached table is stored with the adapter's
+  # +method_table_signature+ for the module, and is discarded when the
+  # signature changes. Tables are keyed on the module's object ID rather
+  # than the module itself, so the cache does not keep modules (e.g.,
+  # classes replaced by Rails code reloading) alive, and is unaffected by
+  # GC.compact.
+  #
+  # The cache is bounded by the total number of methods it holds. When
+  # it is full, the least recently used tables are evicted.
+  #
+  class MethodCache
+    #
+    # The size of the default cache, in methods.
+    #
+    DEFAULT_MAX_SIZE = 100_000
+
+    def initialize(max_size)
+      @max_size = max_size
+      @tables = {}
+      @size = 0
+    end
+
+    #
+    # The maximum total number of methods held.
+    #
+    attr_reader :max_size
+
+    #
+    # The total number of methods currently held.
+    #
+    attr_reader :size
+
+    #
+    # Return the hash of method names to visibilities for the given
+    # module, as returned by the adapter's
+    # +instance_method_visibilities_by_symbol+. The returned hash is
+    # frozen.
+    #
+    def fetch(mod)
+      adapter = Looksee.adapter
+      signature = adapter.method_table_signature(mod) or
+        return adapter.instance_method_visibilities_by_symbol(mod).freeze
+
+      key = Looksee.safe_call(Kernel, :object_id, mod)
+      if (table = @tables.delete(key))
+        if table.signature == signature
+          @tables[key] = table
+          return table.methods
+        end
+        @size -= table.methods.size
+      end
+
+      methods = adapter.instance_method_visibilities_by_symbol(mod).freeze
+      store(key, Table.new(signature, methods))
+      methods
+    end
+
+    #
+    # Remove all cached tables.
+    #
+    def clear
+      @tables.clear
+      @size = 0
+    end
+
+    Table = Struct.new(:signature, :methods) # :nodoc:
+
+    private  # -------------------------------------------------------
+
+    def store(key, table)
+      return if table.methods.size > @max_size
+      @tables[key] = table
+      @size += table.methods.size
+      while @size > @max_size
+        _, evicted = @tables.shift
+        @size -= evicted.methods.size
+      end
+    end
+  end
+end
@@ -0,0 +1,98 @@
+module Looksee
+  #
+  # Metadata for the methods defined directly in a module, stored as
+  # parallel arrays indexed by method.
+  #
+  class MethodMetadata
+    def initialize(names, visibilities, types, original_names, original_owners, arities)
+      @names = names
+      @visibilities = visibilities
+      @types = types
+      @original_names = original_names
+      @original_owners = original_owners
+      @arities = arities
+      @indices = {}
+      names.each_with_index { |name, i| @indices[name] = i }
+    end
+
+    #
+    # The method names, as strings.
+    #
+    attr_reader :names
+
+    #
+    # The method visibilities (:public, :protected, :private, or
+    # :undefined).
+    #
+    attr_reader :visibilities
+
+    #
+    # The method types, as symbols. These are:
+    #
+    # * :iseq - defined in Ruby with +def+
+    # * :cfunc - defined in C
+    # * :attr_reader, :attr_writer
+    # * :bmethod - defined with +define_method+
+    # * :zsuper - visibility changed from a superclass' method
+    # * :alias - an alias of another method, in this module or another
+    # * :refined - refined by a refinement
+    # * :optimized - e.g. Kernel#send, Proc#call
+    # * :missing - dispatched to method_missing
+    # * :not_implemented - not implemented on this platform
+    # * :undefined - undefined with Module#undef_method
+    #
+    attr_reader :types
+
+    #
+    # The names the methods were originally defined with, which differ
+    # from #names for aliases.
+    #
+    attr_reader :original_names
+
+    #
+    # The modules the methods were originally defined in, which differ
+    # from the module itself for aliases of methods in other modules.
+    #
+    attr_reader :original_owners
+
+    #
+    # The method arities, as returned by Method#arity, or nil if
+    # unknown.
+    #
+    attr_reader :arities
+
+    #
+    # Return the number of methods.
+    #
+    def size
+      @names.size
+    end
+
+    #
+    # Return the names of the methods of the given type.
+    #
+    def names_of_type(type)
+      result = []
+      @types.each_with_index do |t, i|
+        result << @names[i] if t == type
+      end
+      result
+    end
+
+    #
+    # Return a hash of the metadata for the named method, or nil if
+    # there is no such method.
+    #
+    def [](name)
+      i = @indices[name.to_s] or
+        return nil
+      {
+        :visibility => @visibilities[i],
+        :type => @types[i],
+        :original_name => @original_names[i],
+        :original_owner => @original_owners[i],
+        :arity => @arities[i],
+      }
+    end
+  end
+end
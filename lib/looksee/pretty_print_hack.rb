@@ -1,14 +1,60 @@
 module Looksee
   module PrettyPrintHack
     def pretty_print(pp)
+      # When pp prints straight to the terminal, write to it ourselves, so
+      # output starts as soon as the first module is ready. pp adds the
+      # final newline.
+      if respond_to?(:each_chunk) && Looksee.stream && PrettyPrintHack.streamable?(pp)
+        each_chunk do |chunk|
+          $stdout.write(chunk)
+          $stdout.flush
+        end
+        return
+      end
+
       # In the default IRB inspect mode (pp), IRB assumes that an inspect string
       # that doesn't look like a bunch of known patterns is a code blob, and
       # formats accordingly. That messes up our color escapes.
-      if Object.const_defined?(:IRB) && IRB.const_defined?(:ColorPrinter) && pp.is_a?(IRB::ColorPrinter)
+      if PrettyPrintHack.irb_color_printer?(pp)
         PP.instance_method(:text).bind(pp).call(inspect)
       else
         pp.text(inspect)
       end
     end
+
+    #
+    # Return true if the object being printed is the one +pp+ was asked
+    # to print, and what +pp+ prints ends up on standard output, which is
+    # a terminal. This is so when +pp+ writes to $stdout, or is the
+    # printer IRB uses to show results, which IRB prints to $stdout.
+    #
+    def self.terminal_output?(pp)
+      top_level?(pp) && (pp.output.equal?($stdout) || irb_color_printer?(pp)) && $stdout.tty?
+    end
+
+    #
+    # Return true if output can be written straight to standard output in
+    # place of what +pp+ would print there, without coming out of order:
+    # +pp+ writes to $stdout, which is a terminal, and the object being
+    # printed is not nested in another. IRB buffers what its printer
+    # prints, to show it after "=>", possibly through its own pager, so
+    # results are never streamed there.
+    #
+    def self.streamable?(pp)
+      top_level?(pp) && pp.output.equal?($stdout) && $stdout.tty?
+    end
+
+    #
+    # PP#pp prints each object in a group of its own, so one printed
+    # directly has a depth of 1 (or 0 if #pretty_print was called
+    # directly), and one nested in another, deeper.
+    #
+    def self.top_level?(pp) # :nodoc:
+      pp.current_group.depth <= 1
+    end
+
+    def self.irb_color_printer?(pp) # :nodoc:
+      Object.const_defined?(:IRB) && IRB.const_defined?(:ColorPrinter) && pp.is_a?(IRB::ColorPrinter)
+    end
   end
 end
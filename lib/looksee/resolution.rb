@@ -0,0 +1,69 @@
+module Looksee
+  #
+  # Where a method is found in an object's lookup path, along with every
+  # other module in it defining the method, in the order +super+ would
+  # call them.
+  #
+  #   resolution = Looksee.resolve(user, :save)
+  #   resolution.owner  # => the module whose method is called
+  #   resolution.chain  # => [[User, :public], [Validations, :public], ...]
+  #
+  class Resolution
+    include PrettyPrintHack
+
+    #
+    # Create a resolution of the named method from the flat array of
+    # modules and visibilities returned by the adapter's +resolve+.
+    #
+    def initialize(name, definitions)
+      @name = name.to_sym
+      @chain = definitions.each_slice(2).to_a
+    end
+
+    #
+    # The name of the method, as a Symbol.
+    #
+    attr_reader :name
+
+    #
+    # The modules defining the method, as [module, visibility] pairs,
+    # in the order +super+ would call them. If the last is :undefined,
+    # the method is undefined there, and nothing past it can be called.
+    #
+    attr_reader :chain
+
+    #
+    # Return true if calling the method would find it.
+    #
+    def found?
+      !@chain.empty? && @chain.first[1] != :undefined
+    end
+
+    #
+    # Return the module whose method is called, or nil if the method is
+    # not found.
+    #
+    def owner
+      found? ? @chain.first[0] : nil
+    end
+
+    #
+    # Return the visibility of the method called, or nil if the method
+    # is not found.
+    #
+    def visibility
+      found? ? @chain.first[1] : nil
+    end
+
+    #
+    # Show each module defining the method, in the order +super+ would
+    # call them.
+    #
+    def inspect
+      styles = Looksee.styles
+      @chain.map do |mod, visibility|
+        "#{styles[:module] % Looksee.adapter.describe_module(mod)}  #{styles[visibility] % name}"
+      end.join("\n")
+    end
+  end
+end
@@ -0,0 +1,520 @@
+module Looksee
+  #
+  # A snapshot of the modules of a process, with their lookup paths and
+  # methods, saved in a compact binary file which can be inspected
+  # later, without the process or the application it was running.
+  #
+  #   # In the process:
+  #   Looksee::Snapshot.dump('app.lsnap')
+  #
+  #   # Anywhere:
+  #   snapshot = Looksee::Snapshot.load('app.lsnap')
+  #   snapshot.look('User', :nooverridden)
+  #
+  # Modules are identified by their descriptions, as shown by
+  # Inspector. Where several share a description, such as classes
+  # reloaded under the same name, the one the constant refers to wins.
+  # Singleton classes of objects other than modules are left out.
+  #
+  # == Format
+  #
+  # All integers are unsigned and little-endian. The file starts with a
+  # header of:
+  #
+  #   magic ("LKSN"), version (32-bit), string count, module count,
+  #   chain length, method count, pid, Ruby description (string index),
+  #   all 32-bit, then creation time (seconds since the epoch), and the
+  #   offsets of the string offsets, string data, modules, chains and
+  #   methods sections, all 64-bit.
+  #
+  # followed by the sections:
+  #
+  # * string offsets: one 32-bit offset per string into the string
+  #   data, then the end offset. Every string in the file is stored
+  #   once here, and referred to by index.
+  # * string data: UTF-8.
+  # * modules: 32-bit description (string index), flags (1: class, 2:
+  #   singleton class), superclass (module index), chain start, chain
+  #   length, first method, method count.
+  # * chains: 32-bit module indices. A module's ancestors are its chain
+  #   followed by its superclass's ancestors.
+  # * methods: 32-bit name, visibility (0: public, 1: protected, 2:
+  #   private, 3: undefined), type (string index), source file (string
+  #   index) and source line (0 if none). Each module's methods are
+  #   sorted by name.
+  #
+  # Absent indices are 0xffffffff.
+  #
+  class Snapshot
+    FormatError = Class.new(RuntimeError)
+
+    MAGIC = 'LKSN'.freeze
+    FORMAT_VERSION = 1
+    NONE = 0xffffffff
+    HEADER = 'a4L<7Q<6'.freeze
+    HEADER_SIZE = 80
+    MODULE = 'L<7'.freeze
+    MODULE_SIZE = 28
+    METHOD = 'L<5'.freeze
+    METHOD_SIZE = 20
+    CLASS_FLAG = 1
+    SINGLETON_FLAG = 2
+    VISIBILITIES = [:public, :protected, :private, :undefined].freeze
+
+    class << self
+      #
+      # Write a snapshot of the current process to +path+, and return
+      # +path+. The file is written under a temporary name and renamed
+      # into place, so readers never see a partial snapshot.
+      #
+      def dump(path)
+        temporary_path = "#{path}.#{Process.pid}.tmp"
+        File.binwrite(temporary_path, Writer.new.write)
+        File.rename(temporary_path, path)
+        path
+      end
+
+      #
+      # Dump a snapshot whenever the process receives +signal+, and
+      # return the previous handler.
+      #
+      # In +path+, "%p" is replaced with the process ID, and "%t" with
+      # the time, so that successive dumps do not overwrite each other.
+      # The dump runs in a new thread, as little may be done in a trap
+      # handler.
+      #
+      def dump_on_signal(signal='USR2', path='looksee-%p-%t.lsnap')
+        Signal.trap(signal) do
+          Thread.new do
+            dump(path.gsub(/%[pt%]/, '%p' => Process.pid.to_s, '%t' => Time.now.strftime('%Y%m%d%H%M%S'), '%%' => '%'))
+          end
+        end
+      end
+
+      #
+      # Read the snapshot at +path+.
+      #
+      def load(path)
+        new(File.binread(path))
+      end
+    end
+
+    #
+    # Create a snapshot from the contents of a snapshot file.
+    #
+    # Raises FormatError if +data+ is not a snapshot in a supported
+    # format.
+    #
+    def initialize(data)
+      @data = data
+      @strings = {}
+      @ancestor_indices = {}
+      data.bytesize >= HEADER_SIZE or
+        raise FormatError, "not a Looksee snapshot"
+      magic, version, @string_count, @module_count, _, _, @pid, ruby, created_at,
+        @strings_offset, @string_data_offset, @modules_offset, @chains_offset, @methods_offset =
+        data.byteslice(0, HEADER_SIZE).unpack(HEADER)
+      magic == MAGIC or
+        raise FormatError, "not a Looksee snapshot"
+      version == FORMAT_VERSION or
+        raise FormatError, "unsupported snapshot version: #{version}"
+      @ruby_description = string(ruby)
+      @created_at = Time.at(created_at)
+    end
+
+    #
+    # The ID of the process the snapshot was taken from.
+    #
+    attr_reader :pid
+
+    #
+    # The RUBY_DESCRIPTION of the process the snapshot was taken from.
+    #
+    attr_reader :ruby_description
+
+    #
+    # The time the snapshot was taken.
+    #
+    attr_reader :created_at
+
+    #
+    # Return the descriptions of all modules in the snapshot.
+    #
+    def modules
+      (0...@module_count).map { |i| string(module_record(i)[0]) }
+    end
+
+    #
+    # Return true if the snapshot has a module with the given
+    # description.
+    #
+    def include?(description)
+      index.key?(description)
+    end
+
+    #
+    # Return the descriptions of the ancestors of the given module, as
+    # Module#ancestors would, but without the Churn hooks.
+    #
+    def ancestors(description)
+      ancestor_indices(module_index(description)).map { |i| string(module_record(i)[0]) }
+    end
+
+    #
+    # Return a hash of the names of the methods defined directly in the
+    # given module to their visibilities, as
+    # Adapter#instance_method_visibilities would.
+    #
+    def method_table_for(description)
+      method_table(module_index(description))
+    end
+
+    #
+    # Return a hash of the :visibility, :type, :file and :line of the
+    # given method, defined directly in the given module, or nil if it
+    # is not.
+    #
+    def method_info(description, name)
+      record = module_record(module_index(description))
+      each_method_record(record) do |method_name, visibility, type, file, line|
+        next if string(method_name) != name.to_s
+        return {
+          :visibility => VISIBILITIES[visibility],
+          :type => type == NONE ? nil : string(type).to_sym,
+          :file => file == NONE ? nil : string(file),
+          :line => line == 0 ? nil : line,
+        }
+      end
+      nil
+    end
+
+    #
+    # Return the lookup path of instances of the given module, as a
+    # Snapshot::LookupPath.
+    #
+    def lookup_path(description)
+      LookupPath.new(self, description)
+    end
+
+    #
+    # Return an Inspector for instances of the given module, like
+    # Looksee.[]. Only the visibility and filter specifiers apply.
+    #
+    def look(description, *specifiers)
+      options = Looksee.parse_specifiers(specifiers)
+      Inspector.new(lookup_path(description), :visibilities => options[:visibilities], :filters => options[:filters])
+    end
+
+    def inspect
+      "#<#{self.class.name} pid=#{pid} modules=#{@module_count} created_at=#{created_at}>"
+    end
+
+    def method_table(i) # :nodoc:
+      Hash[method_list(i)]
+    end
+
+    #
+    # Return the names and visibilities of the methods defined directly
+    # in the given module, sorted by name.
+    #
+    def method_list(i) # :nodoc:
+      list = []
+      each_method_record(module_record(i)) do |name, visibility, _, _, _|
+        list << [string(name), VISIBILITIES[visibility]]
+      end
+      list
+    end
+
+    #
+    # Return a SourceLocations for the methods defined directly in the
+    # given module, as Adapter#source_locations would.
+    #
+    def source_locations(i) # :nodoc:
+      files = []
+      file_indices = {}
+      names = []
+      method_file_indices = []
+      lines = []
+      each_method_record(module_record(i)) do |name, visibility, _, file, line|
+        next if VISIBILITIES[visibility] == :undefined
+        names << string(name)
+        if file == NONE
+          method_file_indices << nil
+          lines << nil
+        else
+          method_file_indices << (file_indices[file] ||= (files << string(file)).size - 1)
+          lines << (line == 0 ? nil : line)
+        end
+      end
+      Looksee.shareable(SourceLocations.new(files, names, method_file_indices, lines))
+    end
+
+    def ancestor_indices(i) # :nodoc:
+      @ancestor_indices[i] ||= begin
+        _, _, superclass, chain_start, chain_length, _, _ = module_record(i)
+        chain = @data.byteslice(@chains_offset + 4*chain_start, 4*chain_length).unpack('L<*')
+        superclass == NONE ? chain : chain + ancestor_indices(superclass)
+      end
+    end
+
+    def module_description(i) # :nodoc:
+      string(module_record(i)[0])
+    end
+
+    #
+    # Return a hash of module descriptions to module indices.
+    #
+    def index # :nodoc:
+      @index ||= (0...@module_count).each_with_object({}) do |i, index|
+        index[module_description(i)] ||= i
+      end
+    end
+
+    def module_index(description) # :nodoc:
+      index[description] or
+        raise ArgumentError, "no such module in snapshot: #{description}"
+    end
+
+    private
+
+    def module_record(i)
+      @data.byteslice(@modules_offset + MODULE_SIZE*i, MODULE_SIZE).unpack(MODULE)
+    end
+
+    def each_method_record(record)
+      start, count = record[5], record[6]
+      @data.byteslice(@methods_offset + METHOD_SIZE*start, METHOD_SIZE*count).unpack('L<*').each_slice(5) do |fields|
+        yield(*fields)
+      end
+    end
+
+    def string(i)
+      @strings[i] ||= begin
+        first, last = @data.byteslice(@strings_offset + 4*i, 8).unpack('L<2')
+        @data.byteslice(@string_data_offset + first, last - first).force_encoding(Encoding::UTF_8)
+      end
+    end
+
+    #
+    # The lookup path of instances of a module in a snapshot, for an
+    # Inspector.
+    #
+    class LookupPath
+      def initialize(snapshot, description)
+        @object = description
+        @entries = entries = []
+        definitions = Looksee::LookupPath::Definitions.new(entries)
+        snapshot.ancestor_indices(snapshot.module_index(description)).each_with_index do |i, index|
+          entries << Entry.new(snapshot, i, definitions, index)
+        end
+      end
+
+      #
+      # The description of the module whose instances this lookup path
+      # is for.
+      #
+      attr_reader :object
+
+      #
+      # List of Entry objects, one for each module in the lookup path.
+      #
+      attr_reader :entries
+    end
+
+    #
+    # An entry in a snapshot's LookupPath. Its methods are decoded from
+    # the snapshot when first needed.
+    #
+    class Entry < Looksee::LookupPath::Entry
+      def initialize(snapshot, module_index, definitions, index)
+        @snapshot = snapshot
+        @module_index = module_index
+        @definitions = definitions
+        @index = index
+      end
+
+      def description
+        @snapshot.module_description(@module_index)
+      end
+
+      def constants
+        {}
+      end
+
+      #
+      # Return the SourceLocations of the module's methods, as recorded
+      # in the snapshot.
+      #
+      def source_locations
+        @source_locations ||= @snapshot.source_locations(@module_index)
+      end
+
+      private  # -----------------------------------------------------
+
+      def find_methods
+        methods = {}
+        @snapshot.method_list(@module_index).each do |name, visibility|
+          methods[name.to_sym] = visibility
+        end
+        methods
+      end
+    end
+
+    #
+    # Builds the contents of a snapshot file.
+    #
+    class Writer # :nodoc:
+      def initialize
+        @strings = {}
+        @modules = []
+        @module_indices = {}.compare_by_identity
+        @ancestors = {}.compare_by_identity
+      end
+
+      def write
+        adapter = Looksee.adapter
+        stale = []
+        ObjectSpace.each_object(Module) do |mod|
+          instance = adapter.singleton_instance(mod)
+          next if instance && !instance.is_a?(Module)
+          current?(mod) ? add_module(mod) : stale << mod
+        end
+        stale.each { |mod| add_module(mod) }
+
+        records = []
+        chains = []
+        methods = []
+        i = 0
+        while i < @modules.size
+          mod = @modules[i]
+          superclass, chain = chain(mod)
+          records << [
+            intern(adapter.describe_module(mod)), flags(mod), superclass,
+            chains.size, chain.size, methods.size / 5, 0,
+          ]
+          chain.each { |ancestor| chains << add_module(ancestor) }
+          add_methods(mod, methods)
+          records.last[6] = methods.size / 5 - records.last[5]
+          i += 1
+        end
+        ruby = intern(RUBY_DESCRIPTION)
+
+        string_offsets = [0]
+        string_data = String.new(encoding: Encoding::BINARY)
+        @strings.each_key do |string|
+          string_data << string.b
+          string_offsets << string_data.bytesize
+        end
+
+        strings_offset = HEADER_SIZE
+        string_data_offset = strings_offset + 4*string_offsets.size
+        modules_offset = string_data_offset + string_data.bytesize
+        chains_offset = modules_offset + MODULE_SIZE*records.size
+        methods_offset = chains_offset + 4*chains.size
+        header = [
+          MAGIC, FORMAT_VERSION, @strings.size, records.size, chains.size, methods.size / 5,
+          Process.pid, ruby, Time.now.to_i,
+          strings_offset, string_data_offset, modules_offset, chains_offset, methods_offset,
+        ]
+        [
+          header.pack(HEADER),
+          string_offsets.pack('L<*'),
+          string_data,
+          records.flatten.pack('L<*'),
+          chains.pack('L<*'),
+          methods.pack('L<*'),
+        ].join
+      end
+
+      private
+
+      def add_module(mod)
+        @module_indices[mod] ||= begin
+          @modules << mod
+          @modules.size - 1
+        end
+      end
+
+      #
+      # Return false if +mod+ is named, but no longer the value of the
+      # constant it is named after.
+      #
+      def current?(mod)
+        name = Looksee.safe_call(Module, :name, mod) or
+          return true
+        scope = Object
+        name.split('::').each do |segment|
+          return false if Looksee.safe_call(Module, :autoload?, scope, segment) ||
+            !Looksee.safe_call(Module, :const_defined?, scope, segment, false)
+          scope = Looksee.safe_call(Module, :const_get, scope, segment, false)
+          return false if !(Module === scope)
+        end
+        scope.equal?(mod)
+      rescue NameError
+        false
+      end
+
+      def intern(string)
+        @strings[string] ||= @strings.size
+      end
+
+      # Leaves out the Churn hooks, like Adapter::Base#lookup_modules.
+      def ancestors(mod)
+        @ancestors[mod] ||= begin
+          ancestors = Looksee.safe_call(Module, :ancestors, mod)
+          ancestors = ancestors.reject { |ancestor| Churn.hook?(ancestor) } if Looksee.adapter.churn_installed?
+          ancestors
+        end
+      end
+
+      def superclass(mod)
+        Class === mod ? Looksee.safe_call(Class, :superclass, mod) : nil
+      end
+
+      def flags(mod)
+        flags = 0
+        flags |= CLASS_FLAG if Class === mod
+        flags |= SINGLETON_FLAG if Looksee.adapter.singleton_instance(mod)
+        flags
+      end
+
+      #
+      # Return the index of the superclass of +mod+ and the part of its
+      # ancestors before those of its superclass. If its ancestors do
+      # not end with its superclass's, the chain is all of them.
+      #
+      def chain(mod)
+        ancestors = ancestors(mod)
+        superclass = superclass(mod) or
+          return [NONE, ancestors]
+        super_ancestors = ancestors(superclass)
+        local_size = ancestors.size - super_ancestors.size
+        if local_size >= 0 && ancestors[local_size..-1] == super_ancestors
+          [add_module(superclass), ancestors[0, local_size]]
+        else
+          [NONE, ancestors]
+        end
+      end
+
+      def add_methods(mod, methods)
+        adapter = Looksee.adapter
+        metadata = adapter.method_metadata(mod)
+        locations = adapter.source_locations(mod)
+        location_indices = {}
+        locations.names.each_with_index { |name, i| location_indices[name] = i }
+        (0...metadata.size).sort_by { |i| metadata.names[i] }.each do |i|
+          name = metadata.names[i]
+          file = line = nil
+          if (j = location_indices[name]) && (file_index = locations.file_indices[j])
+            file = locations.files[file_index]
+            line = locations.lines[j]
+          end
+          methods.push(
+            intern(name), VISIBILITIES.index(metadata.visibilities[i]), intern(metadata.types[i].to_s),
+            file ? intern(file) : NONE, line || 0,
+          )
+        end
+      end
+    end
+  end
+end
@@ -0,0 +1,69 @@
+module Looksee
+  #
+  # The source locations of the methods defined directly in a module.
+  #
+  # Files are stored once in a file table, and each method refers to
+  # its file by index.
+  #
+  class SourceLocations
+    def initialize(files, names, file_indices, lines)
+      @files = files
+      @names = names
+      @file_indices = file_indices
+      @lines = lines
+      @indices = {}
+      names.each_with_index { |name, i| @indices[name] = i }
+    end
+
+    #
+    # The distinct source files of the methods.
+    #
+    attr_reader :files
+
+    #
+    # The method names, as strings.
+    #
+    attr_reader :names
+
+    #
+    # The index into #files of each method's source file, or nil if it
+    # has no source location.
+    #
+    attr_reader :file_indices
+
+    #
+    # The line number of each method, or nil if it has no source
+    # location.
+    #
+    attr_reader :lines
+
+    #
+    # Return the source location of the named method as a file and line
+    # number, or nil if it has none.
+    #
+    def [](name)
+      i = @indices[name.to_s] or
+        return nil
+      file_index = @file_indices[i] or
+        return nil
+      [@files[file_index], @lines[i]]
+    end
+
+    #
+    # Return a hash of each source file to the names of the methods
+    # defined in it, sorted by line.
+    #
+    def group_by_file
+      groups = Array.new(@files.size) { [] }
+      @file_indices.each_with_index do |file_index, i|
+        groups[file_index] << i if file_index
+      end
+      result = {}
+      @files.each_with_index do |file, file_index|
+        indices = groups[file_index].sort_by { |i| @lines[i] }
+        result[file] = indices.map { |i| @names[i] }
+      end
+      result
+    end
+  end
+end
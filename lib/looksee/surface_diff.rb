@@ -0,0 +1,274 @@
+module Looksee
+  #
+  # The changes in method surface between two Snapshots, such as before
+  # and after a deploy, or between two workers.
+  #
+  #   diff = Looksee.diff_surface('before.lsnap', 'after.lsnap')
+  #   diff.changes  # => [#<struct Change kind=:added, ...>, ...]
+  #   diff          # => changes grouped by module
+  #
+  # Methods defined directly in each module are compared by a merge over
+  # the modules and method names, both sorted, in the two snapshots.
+  # Owner changes, where a method is now found in a different module in
+  # some module's lookup path, are then worked out for the names that
+  # changed, and for modules whose ancestors changed.
+  #
+  # Modules in only one of the snapshots are not reported.
+  #
+  class SurfaceDiff
+    include PrettyPrintHack
+
+    #
+    # A change to one method of one module.
+    #
+    # +kind+ is one of:
+    #
+    # * :added - +name+ is now defined directly in +module+, with
+    #   visibility +to+
+    # * :removed - +name+ is no longer defined directly in +module+,
+    #   having had visibility +from+
+    # * :visibility - the visibility of +name+ in +module+ changed from
+    #   +from+ to +to+. Undefining a method counts as a change to
+    #   :undefined.
+    # * :owner - +name+ is now found in +to+ instead of +from+ in the
+    #   lookup path of +module+. Either may be nil if not found, but
+    #   only if the module's ancestors changed; otherwise the method
+    #   is reported as added or removed where it was defined.
+    #
+    # Modules are given by their descriptions, as in the Inspector.
+    #
+    Change = Struct.new(:kind, :module, :name, :from, :to)
+
+    KINDS = [:added, :removed, :visibility, :owner].freeze
+
+    #
+    # Compare the Snapshots +a+ and +b+, either of which may be given as
+    # a path.
+    #
+    def self.build(a, b)
+      a = Snapshot.load(a) if a.is_a?(String)
+      b = Snapshot.load(b) if b.is_a?(String)
+      new(Comparison.new(a, b).changes)
+    end
+
+    def initialize(changes)
+      @changes = changes
+    end
+
+    #
+    # The Changes, sorted by module, then method name.
+    #
+    attr_reader :changes
+
+    #
+    # Return true if nothing changed.
+    #
+    def empty?
+      changes.empty?
+    end
+
+    #
+    # Return the number of changes of each kind.
+    #
+    def counts
+      counts = Hash[KINDS.map { |kind| [kind, 0] }]
+      changes.each { |change| counts[change.kind] += 1 }
+      counts
+    end
+
+    #
+    # Write the changes to +io+ as newline-delimited JSON, one object
+    # per change, and return +io+:
+    #
+    #   {"kind":"added","module":"Foo","name":"bar","from":null,"to":"public"}
+    #
+    def to_ndjson(io='')
+      require 'json'
+      changes.each do |change|
+        io << JSON.generate(
+          'kind' => change.kind.to_s, 'module' => change.module, 'name' => change.name,
+          'from' => change.from && change.from.to_s, 'to' => change.to && change.to.to_s,
+        ) << "\n"
+      end
+      io
+    end
+
+    #
+    # Show the changes under each module, like:
+    #
+    #   Foo
+    #     + bar (public)
+    #     - baz (private)
+    #     ~ qux public -> private
+    #     > to_s Object -> Foo
+    #
+    # Method names are styled by their new visibility, or their old one
+    # if removed, and module names as in the Inspector.
+    #
+    def inspect
+      styles = Looksee.styles
+      lines = []
+      changes.chunk { |change| change.module }.each do |description, module_changes|
+        lines << styles[:module] % description
+        module_changes.each do |change|
+          lines << '  ' + describe_change(change, styles)
+        end
+      end
+      lines.join("\n")
+    end
+
+    private
+
+    def describe_change(change, styles)
+      case change.kind
+      when :added
+        "+ #{styles[change.to] % change.name} (#{change.to})"
+      when :removed
+        "- #{styles[change.from] % change.name} (#{change.from})"
+      when :visibility
+        "~ #{styles[change.to] % change.name} #{change.from} -> #{change.to}"
+      when :owner
+        from = change.from ? styles[:module] % change.from : 'nothing'
+        to = change.to ? styles[:module] % change.to : 'nothing'
+        "> #{change.name} #{from} -> #{to}"
+      end
+    end
+
+    #
+    # Works out the changes between two snapshots.
+    #
+    class Comparison # :nodoc:
+      def initialize(a, b)
+        @a = a
+        @b = b
+        @tables = {a => {}, b => {}}
+      end
+
+      def changes
+        @changes = []
+        @changed_names = {}
+        common = compare_definitions
+        compare_owners(common)
+        order = Hash[KINDS.each_with_index.to_a]
+        @changes.sort_by { |change| [change.module, change.name, order[change.kind]] }
+      end
+
+      private
+
+      #
+      # Merge the sorted modules and their sorted method lists, and
+      # record the added, removed and visibility changes. Return the
+      # descriptions of modules in both snapshots.
+      #
+      def compare_definitions
+        common = []
+        a_modules = @a.index.keys.sort
+        b_modules = @b.index.keys.sort
+        merge(a_modules, b_modules) do |description, in_a, in_b|
+          next unless in_a && in_b
+          common << description
+          a_list = @a.method_list(@a.index[description])
+          b_list = @b.method_list(@b.index[description])
+          merge(a_list, b_list) do |name, a_entry, b_entry|
+            from = a_entry && a_entry[1]
+            to = b_entry && b_entry[1]
+            if from.nil?
+              add(:added, description, name, nil, to)
+            elsif to.nil?
+              add(:removed, description, name, from, nil)
+            elsif from != to
+              add(:visibility, description, name, from, to)
+            end
+          end
+        end
+        common
+      end
+
+      #
+      # For each module in both snapshots, compare the owners of names
+      # which changed somewhere in its ancestors. Methods appearing or
+      # disappearing this way are already reported where they were
+      # defined, so only moves between modules are reported. If the
+      # ancestors themselves changed, compare the owners of all names in
+      # them, and report every difference.
+      #
+      def compare_owners(common)
+        a_descriptions = @a.modules
+        b_descriptions = @b.modules
+        common.each do |description|
+          a_ancestors = @a.ancestor_indices(@a.index[description])
+          b_ancestors = @b.ancestor_indices(@b.index[description])
+          same_ancestors = a_ancestors.map { |i| a_descriptions[i] } == b_ancestors.map { |i| b_descriptions[i] }
+          names = Set.new
+          if same_ancestors
+            a_ancestors.each do |i|
+              changed = @changed_names[a_descriptions[i]] and
+                names.merge(changed)
+            end
+          else
+            a_ancestors.each { |i| names.merge(table(@a, i).keys) }
+            b_ancestors.each { |i| names.merge(table(@b, i).keys) }
+          end
+          next if names.empty?
+          own_changes = @changed_names[description] || Set[]
+          names.each do |name|
+            next if own_changes.include?(name)
+            from = owner(@a, a_ancestors, name)
+            to = owner(@b, b_ancestors, name)
+            next if from == to
+            next if same_ancestors && (from.nil? || to.nil?)
+            add(:owner, description, name, from, to)
+          end
+        end
+      end
+
+      #
+      # Merge two sorted arrays, yielding each key with the matching
+      # element of each array, or nil. Elements which are arrays are
+      # keyed by their first element.
+      #
+      def merge(as, bs)
+        key = proc { |x| x.is_a?(Array) ? x.first : x }
+        i = j = 0
+        while i < as.size || j < bs.size
+          a_key = i < as.size ? key[as[i]] : nil
+          b_key = j < bs.size ? key[bs[j]] : nil
+          if b_key.nil? || (a_key && a_key < b_key)
+            yield a_key, as[i], nil
+            i += 1
+          elsif a_key.nil? || b_key < a_key
+            yield b_key, nil, bs[j]
+            j += 1
+          else
+            yield a_key, as[i], bs[j]
+            i += 1
+            j += 1
+          end
+        end
+      end
+
+      def add(kind, description, name, from, to)
+        @changes << Change.new(kind, description, name, from, to)
+        (@changed_names[description] ||= Set[]) << name unless kind == :owner
+      end
+
+      def table(snapshot, i)
+        @tables[snapshot][i] ||= snapshot.method_table(i)
+      end
+
+      #
+      # Return the description of the module +name+ is found in among
+      # the given module indices, or nil if it is not found or
+      # undefined.
+      #
+      def owner(snapshot, ancestors, name)
+        ancestors.each do |i|
+          visibility = table(snapshot, i)[name] or
+            next
+          return visibility == :undefined ? nil : snapshot.module_description(i)
+        end
+        nil
+      end
+    end
+  end
+end
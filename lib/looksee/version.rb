@@ -8,4 +8,6 @@ module Looksee
       join('.')
     end
   end
+
+  VERSION.freeze
 end
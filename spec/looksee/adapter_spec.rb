@@ -75,6 +75,30 @@ describe "Looksee.adapter" do
         ['[Object instance]', 'M', 'Object', 'Kernel', 'BasicObject']
     end
 
+    it "should contain entries for modules prepended to the singleton class" do
+      temporary_module :M
+      c = Object.new
+      c.singleton_class.send(:prepend, M)
+      filtered_lookup_modules(c).should ==
+        ['M', '[Object instance]', 'Object', 'Kernel', 'BasicObject']
+    end
+
+    it "should contain entries for modules prepended to classes before the class" do
+      temporary_module :M
+      temporary_class(:C) { prepend M }
+      filtered_lookup_modules(C.new).should ==
+        ['M', 'C', 'Object', 'Kernel', 'BasicObject']
+    end
+
+    it "should not contain an entry for an empty singleton class of an instance of a class with prepended modules" do
+      temporary_module :M
+      temporary_class(:C) { prepend M }
+      c = C.new
+      c.singleton_class
+      filtered_lookup_modules(c).should ==
+        ['M', 'C', 'Object', 'Kernel', 'BasicObject']
+    end
+
     it "should work for immediate objects" do
       if RUBY_VERSION >= "2.4.0"
         filtered_lookup_modules(1).first.should == 'Integer'
@@ -84,59 +108,538 @@ describe "Looksee.adapter" do
     end
   end
 
-  describe ".undefined_instance_methods" do
-    def self.target_method(name)
-      define_method(:target_method){name}
+  describe "#resolve" do
+    it "should return the modules defining the method in super order" do
+      temporary_module(:M) { def f; end }
+      temporary_module(:P) { private; def f; end }
+      temporary_class(:B) { def f; end }
+      temporary_class(:C, superclass: B) { include M; prepend P; def f; end }
+      @adapter.resolve(C.new, :f).should == [P, :private, C, :public, M, :public, B, :public]
     end
 
-    if Looksee.ruby_engine == 'ruby' && RUBY_VERSION >= '2.3' && RUBY_VERSION < '3.2'
-      it "just returns an empty array" do
-        temporary_class :C
-        add_methods C, undefined: [:f]
-        @adapter.undefined_instance_methods(C).should == []
+    it "should start at the singleton class of the object" do
+      temporary_class(:C) { def f; end }
+      object = C.new
+      def object.f; end
+      @adapter.resolve(object, 'f').should == [object.singleton_class, :public, C, :public]
+    end
+
+    it "should stop at the first module undefining the method" do
+      temporary_class(:B) { def f; end }
+      temporary_class(:C, superclass: B) { undef_method :f }
+      temporary_class(:D, superclass: C) { def f; end }
+      @adapter.resolve(D.new, :f).should == [D, :public, C, :undefined]
+    end
+
+    it "should return an empty array if no module defines the method" do
+      @adapter.resolve(Object.new, 'looksee_resolve_no_such_method').should == []
+    end
+
+    it "should find operator methods" do
+      temporary_class(:C) { def +(other); end; def [](i); end; def !; end }
+      [:+, :[], :!].each do |name|
+        @adapter.resolve(C.new, name).first(2).should == [C, :public]
       end
-    else
-      it "should return the list of undefined instance methods directly on a class" do
-        temporary_class :C
-        add_methods(C, undefined: [:f])
-        @adapter.undefined_instance_methods(C).should == [:f]
+    end
+
+    it "should find each method in a module with many methods" do
+      names = (1..1000).map { |i| :"looksee_m#{i}" }
+      temporary_class(:C) { names.each { |name| define_method(name) {} } }
+      names.all? { |name| @adapter.resolve(C.new, name) == [C, :public] }.should == true
+      @adapter.resolve(C.new, :looksee_m0).should == []
+    end
+  end
+
+  describe "#instance_method_visibilities" do
+    it "should return the visibility of each method defined directly in a class" do
+      temporary_class :C
+      add_methods C, public: [:pub], protected: [:pro], private: [:pri], undefined: [:und]
+      @adapter.instance_method_visibilities(C).should ==
+        {'pub' => :public, 'pro' => :protected, 'pri' => :private, 'und' => :undefined}
+    end
+
+    it "should return the visibility of each method defined directly in a module" do
+      temporary_module :M
+      add_methods M, public: [:pub], private: [:pri]
+      @adapter.instance_method_visibilities(M).should == {'pub' => :public, 'pri' => :private}
+    end
+
+    it "should not include inherited methods" do
+      temporary_class :B
+      temporary_class :C, superclass: B
+      add_methods B, public: [:f]
+      add_methods C, public: [:g]
+      @adapter.instance_method_visibilities(C).should == {'g' => :public}
+    end
+
+    it "should include methods of a class with prepended modules" do
+      temporary_module :M
+      temporary_class(:C) { prepend M }
+      add_methods M, public: [:f]
+      add_methods C, public: [:g]
+      @adapter.instance_method_visibilities(C).should == {'g' => :public}
+    end
+
+    it "should include methods of a singleton class" do
+      object = Object.new
+      def object.f; end
+      @adapter.instance_method_visibilities(object.singleton_class).should == {'f' => :public}
+    end
+
+    it "should not include methods only added by refinements" do
+      temporary_class :C
+      add_methods C, public: [:f]
+      Module.new do
+        refine(C) do
+          def f; end
+          def g; end
+        end
+      end
+      @adapter.instance_method_visibilities(C).should == {'f' => :public}
+    end
+
+    it "should raise a TypeError if the argument is not a module" do
+      lambda do
+        @adapter.instance_method_visibilities(Object.new)
+      end.should raise_error(TypeError)
+    end
+  end
+
+  describe "#instance_method_visibilities_by_symbol" do
+    it "should return the visibility of each method defined directly in the module, keyed by Symbol" do
+      temporary_class :C
+      add_methods C, public: [:pub], protected: [:pro], private: [:pri], undefined: [:und]
+      @adapter.instance_method_visibilities_by_symbol(C).should ==
+        {:pub => :public, :pro => :protected, :pri => :private, :und => :undefined}
+    end
+
+    it "should raise a TypeError if the argument is not a module" do
+      lambda do
+        @adapter.instance_method_visibilities_by_symbol(Object.new)
+      end.should raise_error(TypeError)
+    end
+  end
+
+  describe "#method_metadata" do
+    it "should return metadata for each method defined directly in the module" do
+      temporary_class :C
+      add_methods C, public: [:pub], private: [:pri], undefined: [:und]
+      metadata = @adapter.method_metadata(C)
+      metadata.names.sort.should == ['pri', 'pub', 'und']
+      metadata['pub'][:visibility].should == :public
+      metadata['pri'][:visibility].should == :private
+      metadata['und'][:visibility].should == :undefined
+      metadata['und'][:type].should == :undefined
+    end
+
+    it "should return the arity of each method" do
+      temporary_class :C do
+        def f(a, b=1); end
+      end
+      @adapter.method_metadata(C)['f'][:arity].should == -2
+    end
+
+    it "should return the original name of aliases" do
+      temporary_class :C do
+        def f; end
+        alias g f
+      end
+      @adapter.method_metadata(C)['g'][:original_name].should == 'f'
+    end
+
+    it "should return the type of aliases of methods in the same module" do
+      temporary_class :C do
+        def f; end
+        alias_method :g, :f
+      end
+      metadata = @adapter.method_metadata(C)
+      metadata['g'][:type].should == :alias
+      metadata['g'][:original_owner].should equal(C)
+      metadata['f'][:type].should_not == :alias
+    end
+
+    it "should report aliases in the same module the same way in the fallback" do
+      temporary_class :C do
+        def f; end
+        alias_method :g, :f
+      end
+      arrays = Looksee::Adapter::Base.instance_method(:internal_method_metadata).bind(@adapter).call(C)
+      metadata = Looksee::MethodMetadata.new(*arrays)
+      metadata['g'][:type].should == :alias
+      metadata['g'][:original_name].should == 'f'
+    end
+
+    if Looksee.ruby_engine == 'ruby'
+      it "should return the type of each method" do
+        temporary_class :C do
+          def iseq; end
+          attr_reader :reader
+          attr_writer :writer
+          define_method(:bmethod) {}
+        end
+        metadata = @adapter.method_metadata(C)
+        metadata['iseq'][:type].should == :iseq
+        metadata['reader'][:type].should == :attr_reader
+        metadata['writer='][:type].should == :attr_writer
+        metadata['bmethod'][:type].should == :bmethod
+        @adapter.method_metadata(Kernel)['puts'][:type].should == :cfunc
+      end
+
+      it "should return the original owner of methods aliased from other modules" do
+        temporary_module :M do
+          def f; end
+        end
+        temporary_class :C do
+          include M
+          alias_method :g, :f
+        end
+        metadata = @adapter.method_metadata(C)
+        metadata['g'][:type].should == :alias
+        metadata['g'][:original_owner].should equal(M)
+        metadata['g'][:original_name].should == 'f'
+      end
+
+      it "should not return an arity for methods whose visibility was changed from a superclass" do
+        temporary_class :B do
+          def f(a); end
+        end
+        temporary_class :C, superclass: B do
+          private :f
+        end
+        metadata = @adapter.method_metadata(C)
+        metadata['f'][:visibility].should == :private
+        metadata['f'][:arity].should be_nil
+      end
+    end
+
+    it "should raise a TypeError if the argument is not a module" do
+      lambda do
+        @adapter.method_metadata(Object.new)
+      end.should raise_error(TypeError)
+    end
+  end
+
+  describe "#source_locations" do
+    it "should return the source location of each method defined directly in the module" do
+      temporary_class :C
+      line = __LINE__ + 2
+      C.class_eval do
+        def f; end
+        attr_reader :r
+        define_method(:b) {}
+        alias g f
       end
+      locations = @adapter.source_locations(C)
+      locations.files.should == [__FILE__]
+      locations['f'].should == [__FILE__, line]
+      locations['r'].should == [__FILE__, line + 1]
+      locations['b'].should == [__FILE__, line + 2]
+      locations['g'].should == [__FILE__, line]
+    end
+
+    it "should not return a source location for methods defined in C" do
+      @adapter.source_locations(Kernel)['puts'].should be_nil
+    end
+
+    it "should not include undefined methods" do
+      temporary_class :C
+      add_methods C, public: [:pub], undefined: [:und]
+      @adapter.source_locations(C).names.should == ['pub']
+    end
+
+    it "should raise a TypeError if the argument is not a module" do
+      lambda do
+        @adapter.source_locations(Object.new)
+      end.should raise_error(TypeError)
+    end
+  end
+
+  describe "#method_index" do
+    it "should map each method name to the modules defining it and their visibilities" do
+      temporary_module :M
+      temporary_class :C
+      add_methods M, public: [:looksee_adapter_index_test]
+      add_methods C, undefined: [:looksee_adapter_index_test]
+      entries = @adapter.method_index[:looksee_adapter_index_test]
+      entries.each_slice(2).to_a.sort_by { |mod, _| mod.name }.should ==
+        [[C, :undefined], [M, :public]]
+    end
+  end
+
+  describe "#overrides_below" do
+    it "should return the subclasses which override the method" do
+      temporary_class(:A) { def f; end }
+      temporary_class(:B, superclass: A) { def f; end }
+      temporary_class(:C, superclass: A)
+      @adapter.overrides_below(A, :f).should == [[B, :public, []]]
+    end
+
+    it "should nest overrides below the nearest overriding class" do
+      temporary_class(:A) { def f; end }
+      temporary_class(:B, superclass: A) { def f; end }
+      temporary_class(:C, superclass: B)
+      temporary_class(:D, superclass: C) { private; def f; end }
+      @adapter.overrides_below(A, :f).should == [[B, :public, [[D, :private, []]]]]
+    end
+
+    it "should include modules included below the class" do
+      temporary_module(:M) { def f; end }
+      temporary_class(:A) { def f; end }
+      temporary_class(:B, superclass: A) { include M }
+      @adapter.overrides_below(A, :f).should == [[M, :public, []]]
+    end
+
+    it "should place prepended modules below the class they are prepended to" do
+      temporary_module(:M) { def f; end }
+      temporary_class(:A)
+      temporary_class(:B, superclass: A) { prepend M; def f; end }
+      @adapter.overrides_below(A, :f).should == [[B, :public, [[M, :public, []]]]]
+    end
+
+    it "should return overrides in classes which include the given module" do
+      temporary_module(:M) { def f; end }
+      temporary_class(:A) { include M }
+      temporary_class(:B, superclass: A) { def f; end }
+      @adapter.overrides_below(M, :f).should == [[B, :public, []]]
+    end
+
+    it "should not include refinements of the class" do
+      temporary_class(:A) { def f; end }
+      temporary_class(:B, superclass: A) { def f; end }
+      temporary_module(:R) { refine(A) { def f; end } }
+      @adapter.overrides_below(A, :f).should == [[B, :public, []]]
+    end
 
-      it "should return the list of undefined instance methods directly on a module" do
+    it "should return an empty array if no method has the given name" do
+      temporary_class :A
+      @adapter.overrides_below(A, :looksee_no_such_method).should == []
+    end
+
+    it "should raise a TypeError if the argument is not a module" do
+      lambda do
+        @adapter.overrides_below(Object.new, :f)
+      end.should raise_error(TypeError)
+    end
+  end
+
+  describe "#constants" do
+    it "should return the constants defined directly in the module with their values" do
+      temporary_class :B
+      B.const_set(:Inherited, 1)
+      temporary_class :C, superclass: B
+      C.const_set(:X, 2)
+      @adapter.constants(C).should == {'X' => [:public, 2, nil]}
+    end
+
+    it "should return autoload paths without loading the constant" do
+      temporary_module :M
+      M.autoload(:X, '/looksee/nonexistent/x')
+      @adapter.constants(M).should == {'X' => [:public, nil, '/looksee/nonexistent/x']}
+    end
+
+    if Looksee.ruby_engine == 'ruby'
+      it "should include private constants" do
         temporary_module :M
-        add_methods(M, undefined: [:f])
-        @adapter.undefined_instance_methods(M).should == [:f]
+        M.const_set(:X, 1)
+        M.send(:private_constant, :X)
+        @adapter.constants(M).should == {'X' => [:private, 1, nil]}
       end
+    end
+
+    it "should raise a TypeError if the argument is not a module" do
+      lambda do
+        @adapter.constants(Object.new)
+      end.should raise_error(TypeError)
+    end
+  end
+
+  describe "#refinement_for" do
+    it "should return the refinement of the module activated by the refiner" do
+      temporary_class :C
+      refinement = nil
+      temporary_module(:R) { refinement = refine(C) { self } }
+      @adapter.refinement_for(R, C).should equal(refinement)
+    end
+
+    it "should return nil if the refiner does not refine the module" do
+      temporary_class :C
+      temporary_module(:R) { refine(String) {} }
+      @adapter.refinement_for(R, C).should be_nil
+    end
+
+    it "should return nil if the module has no refinements" do
+      temporary_module :R
+      @adapter.refinement_for(R, Object).should be_nil
+    end
+  end
 
-      it "should return the list of undefined instance methods directly on a singleton class" do
+  if Looksee.ruby_engine == 'ruby'
+    describe "#method_table_usage" do
+      it "should return the memsize, size and capacity of the method table" do
         temporary_class :C
-        c = C.new
-        add_methods(c.singleton_class, undefined: [:f])
-        @adapter.undefined_instance_methods(c.singleton_class).should == [:f]
+        add_methods C, public: [:f, :g, :h]
+        memsize, size, capacity = @adapter.method_table_usage(C)[:m_tbl]
+        size.should == 3
+        capacity.should >= 3
+        memsize.should > 0
       end
 
-      it "should return the list of undefined instance methods directly on a class' singleton class" do
-        temporary_class :C
-        add_methods(C.singleton_class, undefined: [:f])
-        @adapter.undefined_instance_methods(C.singleton_class).should == [:f]
+      it "should count the method caches of classes including a module" do
+        temporary_module(:M) { def f; end }
+        temporary_class(:C) { include M }
+        C.new.f
+        @adapter.method_table_usage(M)[:callable_m_tbl][1].should == 1
       end
 
-      it "should not return defined methods" do
+      it "should return zeros for tables which have not been allocated" do
         temporary_class :C
-        C.send(:define_method, :f){}
-        @adapter.undefined_instance_methods(C).should == []
+        @adapter.method_table_usage(C)[:callable_m_tbl].should == [0, 0, 0]
       end
 
-      it "should not return removed methods" do
+      it "should raise a TypeError if the argument is not a module" do
+        lambda do
+          @adapter.method_table_usage(Object.new)
+        end.should raise_error(TypeError)
+      end
+    end
+  end
+
+  if Looksee.ruby_engine == 'ruby' && RUBY_VERSION >= '3.0'
+    describe "#call_cache_counts" do
+      it "should count the call cache entries of methods called on the object's class, by owner" do
+        temporary_module(:M) { def f; end }
+        temporary_class(:C) { include M; def g(*args); end; def h; end }
+        object = C.new
+        2.times { object.f; object.g; object.g(1) }
+        counts = @adapter.call_cache_counts(object)
+        counts[M].should == {:f => 1}
+        counts[C].should == {:g => 2}
+      end
+
+      it "should return an empty hash if no methods have been called" do
         temporary_class :C
-        C.send(:define_method, :f){}
-        C.send(:remove_method, :f)
-        @adapter.undefined_instance_methods(C).should == []
+        @adapter.call_cache_counts(C.allocate).should == {}
+      end
+    end
+  end
+
+  describe "#census" do
+    it "should count instances, singleton classes and extensions" do
+      temporary_module :M
+      temporary_class :C
+      objects = Array.new(3) { C.new }
+      objects[0].extend(M)
+      objects[1].singleton_class
+      instances, singletons, extensions = @adapter.census
+      [instances[C], singletons[C], extensions[M]].should == [3, 2, 1]
+    end
+
+    it "should not count classes and modules as having singleton classes" do
+      temporary_class :C
+      C.singleton_class
+      @adapter.census[1][Class].should be_nil
+    end
+  end
+
+  describe "#method_table_signature" do
+    before do
+      temporary_class :C
+      add_methods C, public: [:f]
+      @signature = @adapter.method_table_signature(C)
+    end
+
+    it "should not change if the module's methods do not change" do
+      @adapter.method_table_signature(C).should == @signature
+    end
+
+    it "should change when a method is added" do
+      add_methods C, public: [:g]
+      @adapter.method_table_signature(C).should_not == @signature
+    end
+
+    it "should change when a method's visibility changes" do
+      C.send(:private, :f)
+      @adapter.method_table_signature(C).should_not == @signature
+    end
+
+    it "should change when a method is undefined" do
+      C.send(:undef_method, :f)
+      @adapter.method_table_signature(C).should_not == @signature
+    end
+
+    it "should change when a method is removed" do
+      C.send(:remove_method, :f)
+      @adapter.method_table_signature(C).should_not == @signature
+    end
+
+    if GC.respond_to?(:compact)
+      it "should not change when the heap is compacted" do
+        GC.compact
+        @adapter.method_table_signature(C).should == @signature
       end
+    end
+  end
+
+  describe ".undefined_instance_methods" do
+    def self.target_method(name)
+      define_method(:target_method){name}
+    end
+
+    it "should return the list of undefined instance methods directly on a class" do
+      temporary_class :C
+      add_methods(C, undefined: [:f])
+      @adapter.undefined_instance_methods(C).should == [:f]
+    end
+
+    it "should return the list of undefined instance methods directly on a module" do
+      temporary_module :M
+      add_methods(M, undefined: [:f])
+      @adapter.undefined_instance_methods(M).should == [:f]
+    end
+
+    it "should return the list of undefined instance methods directly on a singleton class" do
+      temporary_class :C
+      c = C.new
+      add_methods(c.singleton_class, undefined: [:f])
+      @adapter.undefined_instance_methods(c.singleton_class).should == [:f]
+    end
+
+    it "should return the list of undefined instance methods directly on a class' singleton class" do
+      temporary_class :C
+      add_methods(C.singleton_class, undefined: [:f])
+      @adapter.undefined_instance_methods(C.singleton_class).should == [:f]
+    end
+
+    it "should return the list of undefined instance methods of a class with prepended modules" do
+      temporary_module :M
+      temporary_class(:C) { prepend M }
+      add_methods(C, undefined: [:f])
+      @adapter.undefined_instance_methods(C).should == [:f]
+    end
+
+    it "should not return defined methods" do
+      temporary_class :C
+      C.send(:define_method, :f){}
+      @adapter.undefined_instance_methods(C).should == []
+    end
 
-      it "should handle the MRI allocator being undefined (e.g. Struct)" do
-        struct_singleton_class = (class << Struct; self; end)
-        @adapter.undefined_instance_methods(struct_singleton_class).should == []
+    it "should not return removed methods" do
+      temporary_class :C
+      C.send(:define_method, :f){}
+      C.send(:remove_method, :f)
+      @adapter.undefined_instance_methods(C).should == []
+    end
+
+    it "should handle the MRI allocator being undefined (e.g. Struct)" do
+      struct_singleton_class = (class << Struct; self; end)
+      @adapter.undefined_instance_methods(struct_singleton_class).should == []
+    end
+
+    it "should raise a TypeError if the argument is not a module" do
+      [1, Object.new].each do |object|
+        lambda do
+          @adapter.internal_undefined_instance_methods(object)
+        end.should raise_error(TypeError)
       end
     end
   end
@@ -184,7 +687,49 @@ describe "Looksee.adapter" do
     end
   end
 
+  describe "#singleton_nesting" do
+    it "should return 0 and the module itself for a plain module" do
+      mod = Module.new
+      @adapter.singleton_nesting(mod).should == [0, mod]
+    end
+
+    it "should return 1 and the object for the singleton class of an object" do
+      object = Object.new
+      depth, instance = @adapter.singleton_nesting(object.singleton_class)
+      depth.should == 1
+      instance.should equal(object)
+    end
+
+    it "should count each level of singleton class" do
+      klass = Class.new
+      @adapter.singleton_nesting(klass.singleton_class.singleton_class).should == [2, klass]
+    end
+  end
+
+  describe "#module_name" do
+    it "should return the name of a module" do
+      @adapter.module_name(Comparable).should == 'Comparable'
+    end
+
+    it "should return an empty string for an unnamed module" do
+      @adapter.module_name(Module.new).should == ''
+    end
+
+    it "should raise a TypeError if the argument is not a module" do
+      [1, Object.new].each do |object|
+        lambda do
+          @adapter.module_name(object)
+        end.should raise_error(TypeError)
+      end
+    end
+  end
+
   describe "#describe_module" do
+    it "should describe unnamed refinements by what they refine" do
+      temporary_module(:R) { refine(String) {} }
+      @adapter.describe_module(@adapter.refinement_for(R, String)).should == '#<refinement:String@R>'
+    end
+
     it "should return the fully-qualified name of a module" do
       begin
         ::M = Module.new
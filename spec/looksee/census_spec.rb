@@ -0,0 +1,72 @@
+require 'spec_helper'
+
+describe Looksee::Census do
+  include TemporaryClasses
+
+  describe ".build" do
+    before do
+      temporary_module :M
+      temporary_module :N
+      temporary_class :C
+      @objects = Array.new(5) { C.new }
+      @objects[0].extend(M)
+      @objects[1].extend(M, N)
+      def (@objects[2]).f; end
+      @census = Looksee::Census.build
+    end
+
+    it "should count the live instances of each class" do
+      @census.instances(C).should == 5
+    end
+
+    it "should count the instances of each class with singleton classes" do
+      @census.singletons(C).should == 3
+    end
+
+    it "should count the objects each module extends" do
+      @census.extensions(M).should == 2
+      @census.extensions(N).should == 1
+    end
+  end
+
+  describe "with given counts" do
+    before do
+      temporary_module :M
+      temporary_class :C
+      temporary_class :D
+      @census = Looksee::Census.new({C => 10, D => 3}, {C => 2}, {M => 4})
+    end
+
+    it "should return zero for modules not counted" do
+      @census.instances(M).should == 0
+      @census.singletons(D).should == 0
+      @census.extensions(C).should == 0
+    end
+
+    it "should rank modules by each count" do
+      @census.top_instances.should == [[C, 10], [D, 3]]
+      @census.top_instances(1).should == [[C, 10]]
+      @census.top_singletons.should == [[C, 2]]
+      @census.top_extensions.should == [[M, 4]]
+    end
+
+    it "should describe the nonzero counts for a module" do
+      @census.describe(C).should == '10 instances, 2 singletons'
+      @census.describe(M).should == 'extends 4'
+      @census.describe(Object).should == ''
+    end
+
+    it "should show the rankings when inspected" do
+      Looksee.stub(:styles).and_return(Hash.new{'%s'})
+      @census.inspect.should == <<-EOS.demargin.chomp
+        |Instances
+        |  10  C
+        |   3  D
+        |Singletons
+        |  2  C
+        |Extensions
+        |  4  M
+      EOS
+    end
+  end
+end
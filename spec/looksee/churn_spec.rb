@@ -0,0 +1,153 @@
+require 'spec_helper'
+
+describe Looksee::Churn do
+  include TemporaryClasses
+
+  before do
+    Looksee.stub(:styles).and_return(Hash.new{'%s'})
+  end
+
+  after do
+    Looksee::Churn.stop
+  end
+
+  describe ".start" do
+    it "should start recording method definitions" do
+      temporary_class :C
+      churn = Looksee::Churn.start
+      Looksee::Churn.running?.should == true
+      C.send(:define_method, :f) {}
+      churn.count.should == 1
+      churn.module_counts.should == {'C' => 1}
+    end
+
+    it "should leave its hooks out of lookup paths" do
+      Looksee::Churn.start
+      temporary_class :C
+      [C.new, C].each do |object|
+        modules = Looksee.adapter.lookup_modules(object)
+        modules.should_not include(Looksee::Churn::ModuleHooks)
+        modules.should_not include(Looksee::Churn::ObjectHooks)
+      end
+    end
+
+    it "should leave its hooks out of resolutions, method indexes and overrides" do
+      Looksee::Churn.start
+      hooks = [Looksee::Churn::ModuleHooks, Looksee::Churn::ObjectHooks]
+      Looksee.resolve(Object.new, :singleton_method_added).chain.should == [[BasicObject, :private]]
+      Looksee.resolve(Class.new, :method_added).chain.should == [[Module, :private]]
+      index = Looksee.adapter.method_index
+      (index[:method_added].each_slice(2).map(&:first) & hooks).should == []
+      (index[:singleton_method_added].each_slice(2).map(&:first) & hooks).should == []
+      Looksee.adapter.overrides_below(BasicObject, :singleton_method_added).flatten.should_not include(Looksee::Churn::ObjectHooks)
+    end
+  end
+
+  describe ".stop" do
+    it "should stop recording, and return the monitor" do
+      temporary_class :C
+      churn = Looksee::Churn.start
+      Looksee::Churn.stop.should equal(churn)
+      Looksee::Churn.running?.should == false
+      C.send(:define_method, :f) {}
+      churn.count.should == 0
+    end
+
+    it "should leave singleton classes alone while stopped" do
+      temporary_class :C
+      temporary_module :M
+      Looksee::Churn.start
+      Looksee::Churn.stop
+      Looksee.stub(:safe_call) { raise 'looked up' }
+      object = C.new
+      def object.f; end
+      object.extend(M)
+    end
+  end
+
+  describe "recording" do
+    before do
+      temporary_class :C
+      @churn = Looksee::Churn.start
+    end
+
+    it "should record methods being added, removed and undefined" do
+      C.send(:define_method, :f) {}
+      C.send(:define_method, :g) {}
+      C.send(:remove_method, :f)
+      C.send(:undef_method, :g)
+      @churn.events.map { |e| [e.kind, e.module, e.name] }.should ==
+        [[:added, 'C', 'f'], [:added, 'C', 'g'], [:removed, 'C', 'f'], [:undefined, 'C', 'g']]
+    end
+
+    it "should record singleton methods of modules and other objects" do
+      object = C.new
+      def C.f; end
+      def object.g; end
+      @churn.events.map { |e| [e.kind, e.module, e.name] }.should ==
+        [[:singleton_added, '[C]', 'f'], [:singleton_added, '[C instance]', 'g']]
+    end
+
+    it "should record objects being extended" do
+      temporary_module :M
+      C.new.extend(M)
+      @churn.events.map { |e| [e.kind, e.module, e.name] }.should == [[:extended, '[C instance]', 'M']]
+    end
+
+    it "should record the file and line of each change" do
+      line = __LINE__; C.send(:define_method, :f) {}
+      @churn.events.first.site.should == "#{__FILE__}:#{line}"
+      @churn.site_counts.should == {"#{__FILE__}:#{line}" => 1}
+    end
+  end
+
+  describe "#events" do
+    it "should keep only the most recent events, oldest first" do
+      temporary_class :C
+      churn = Looksee::Churn.start(:buffer_size => 3)
+      5.times { |i| C.send(:define_method, "f#{i}") {} }
+      churn.events.map { |e| e.name }.should == ['f2', 'f3', 'f4']
+      churn.count.should == 5
+    end
+
+    it "should record backtraces for every Nth event" do
+      temporary_class :C
+      churn = Looksee::Churn.start(:backtrace_every => 2)
+      3.times { |i| C.send(:define_method, "f#{i}") {} }
+      churn.events.map { |e| !e.backtrace.nil? }.should == [true, false, true]
+      churn.events.first.backtrace.first.should =~ /\A#{Regexp.escape(__FILE__)}:/
+    end
+  end
+
+  describe "reports" do
+    before do
+      temporary_class :C
+      temporary_class :D
+      @churn = Looksee::Churn.start
+      3.times { |i| D.send(:define_method, "f#{i}") {} }
+      C.send(:define_method, :f) {}
+      Looksee::Churn.stop
+    end
+
+    it "should rank modules by the number of events" do
+      @churn.top_modules.should == [['D', 3], ['C', 1]]
+      @churn.top_modules(1).should == [['D', 3]]
+    end
+
+    it "should rank call sites by the number of events" do
+      @churn.top_sites.map { |_, count| count }.should == [3, 1]
+    end
+
+    it "should export counts and events as newline-delimited JSON" do
+      require 'json'
+      lines = @churn.to_ndjson.split("\n").map { |line| JSON.parse(line) }
+      lines.map { |line| line['type'] }.should == ['module', 'module', 'site', 'site', 'event', 'event', 'event', 'event']
+      lines[0].values_at('module', 'count').should == ['D', 3]
+      lines[4].values_at('kind', 'module', 'name').should == ['added', 'D', 'f0']
+    end
+
+    it "should show the ranked modules and call sites when inspected" do
+      @churn.inspect.should =~ /\A4 events in .*\nModules\n  3  .*\/s  D\n  1  .*\/s  C\nCall sites\n/
+    end
+  end
+end
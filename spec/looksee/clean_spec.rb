@@ -32,10 +32,98 @@ describe Looksee do
       inspector.filters.should == Set['aa', /bb/]
     end
 
+    it "should show constants if :constants is given" do
+      Looksee[@object].constants.should == false
+      Looksee[@object, :constants].constants.should == true
+      Looksee[@object, :constants, :noconstants].constants.should == false
+    end
+
+    it "should show memory usage if :memsize is given" do
+      Looksee[@object].memsize.should == false
+      Looksee[@object, :memsize].memsize.should == true
+      Looksee[@object, :memsize, :nomemsize].memsize.should == false
+    end
+
+    it "should highlight called methods if :hot is given" do
+      Looksee[@object].hot.should == false
+      Looksee[@object, :hot].hot.should == true
+      Looksee[@object, :hot, :nohot].hot.should == false
+    end
+
+    it "should show object counts if :census is given" do
+      Looksee[@object].census.should == false
+      Looksee[@object, :census].census.should == true
+      Looksee[@object, :census, :nocensus].census.should == false
+    end
+
+    it "should activate refinements from the given modules" do
+      refiner = Module.new { refine(Object) {} }
+      inspector = Looksee[@object, refiner]
+      inspector.lookup_path.using.should == [refiner]
+    end
+
     it "should raise an ArgumentError if an invalid argument is given" do
       lambda do
         Looksee[@object, Object.new]
       end.should raise_error(ArgumentError)
     end
   end
+
+  describe ".overrides_below" do
+    it "should return the tree of overrides below the given module" do
+      base = Class.new { def f; end }
+      subclass = Class.new(base) { def f; end }
+      Looksee.overrides_below(base, :f).should == [[subclass, :public, []]]
+    end
+  end
+
+  if defined?(Ractor)
+    describe "settings" do
+      it "should be frozen when assigned, so they can be read from any Ractor" do
+        original = Looksee.styles
+        begin
+          Looksee.styles = {:module => '%s'}
+          Looksee.styles.should be_frozen
+          Looksee.styles[:module].should be_frozen
+        ensure
+          Looksee.styles = original
+        end
+      end
+    end
+  end
+
+  if defined?(Ractor) && RUBY_VERSION >= '3.1'
+    describe "in a non-main Ractor" do
+      around do |example|
+        experimental = Warning[:experimental]
+        Warning[:experimental] = false
+        begin
+          example.run
+        ensure
+          Warning[:experimental] = experimental
+        end
+      end
+
+      it "should inspect objects" do
+        ractor = Ractor.new { Looksee[Comparable, :nooverridden].inspect }
+        ractor.take.should == Looksee[Comparable, :nooverridden].inspect
+      end
+
+      it "should return shareable results" do
+        ractor = Ractor.new { Looksee::Index.build }
+        Ractor.shareable?(ractor.take).should == true
+      end
+
+      it "should leave what is not needed in Ractors autoloaded" do
+        script = "require 'looksee/clean'; print Looksee.autoload?(:Snapshot).inspect"
+        output = IO.popen([RbConfig.ruby, "-I#{ROOT}/lib", '-e', script], &:read)
+        output.should == '"looksee/snapshot"'
+      end
+
+      it "should use its own method cache" do
+        ractor = Ractor.new { Looksee.method_cache.equal?(Looksee.method_cache) && Looksee.method_cache.max_size }
+        ractor.take.should == Looksee::MethodCache::DEFAULT_MAX_SIZE
+      end
+    end
+  end
 end
@@ -42,6 +42,37 @@ describe Looksee::Columnizer do
       EOS
     end
 
+    it "should ignore terminal control sequences when measuring strings" do
+      columnize(["\e[1maa\e[0m", 'b', 'c', "\e[31mdd\e[0m"], 8).should ==
+        "  \e[1maa\e[0m  c \n  b   \e[31mdd\e[0m\n"
+    end
+
+    it "should count East Asian wide characters as two columns" do
+      columnize(["\u540D\u524D", 'b', 'c', 'dd'], 10).should ==
+        "  \u540D\u524D  c \n  b     dd\n"
+    end
+
+    it "should count emoji as two columns" do
+      columnize(["a\u{1F600}", 'b', "\u2764\uFE0F", 'dd'], 9).should ==
+        "  a\u{1F600}  \u2764\uFE0F\n  b    dd\n"
+    end
+
+    it "should not count combining marks" do
+      columnize(["e\u0301e\u0301", 'b', 'c', 'dd'], 8).should ==
+        "  e\u0301e\u0301  c \n  b   dd\n"
+    end
+
+    it "should stop adding columns at the first layout which does not fit" do
+      # 2 columns would take 16 characters, though 3 would take 15.
+      columnize(['aa', 'bb', 'cccccc', 'dddddd', 'e'], 15).should == <<-EOS.gsub(/^ *\|/, '')
+        |  aa    
+        |  bb    
+        |  cccccc
+        |  dddddd
+        |  e     
+      EOS
+    end
+
     it "should pad out strings that are shorter than their column" do
       columnize(['aa', 'b', 'c', 'dd'], 8).should == <<-EOS.gsub(/^ *\|/, '')
         |  aa  c 
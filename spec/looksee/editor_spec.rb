@@ -92,6 +92,12 @@ describe Looksee::Editor do
       editor_invocation.should be_nil
     end
 
+    it "should resolve methods whose visibility was changed from a superclass" do
+      subclass = Class.new(C) { private :f }
+      editor.edit(subclass.new, :f)
+      editor_invocation.should == "2 #{source_location.join(' ')}\n"
+    end
+
     it "should raise NoSourceFileError and not run the editor if the source file does not exist" do
       FileUtils.rm_f source_location.first
       expect { editor.edit(object, :f) }.to raise_error(Looksee::NoSourceFileError)
@@ -99,6 +105,7 @@ describe Looksee::Editor do
     end
 
     it "should raise NoSourceLocationError and not run the editor if no source location is available" do
+      Looksee::SourceLocations.any_instance.stub(:[] => nil)
       UnboundMethod.any_instance.stub(source_location: nil)
       expect { editor.edit(object, :f) }.to raise_error(Looksee::NoSourceLocationError)
       editor_invocation.should be_nil
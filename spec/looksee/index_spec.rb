@@ -0,0 +1,90 @@
+require 'spec_helper'
+
+describe Looksee::Index do
+  include TemporaryClasses
+
+  describe ".build" do
+    it "should index the methods of every module in the heap" do
+      temporary_module :M
+      temporary_class :C
+      add_methods M, public: [:looksee_index_visibility_test]
+      add_methods C, private: [:looksee_index_visibility_test]
+      index = Looksee::Index.build
+      index[:looksee_index_visibility_test].should == {M => :public, C => :private}
+    end
+
+    it "should include methods of singleton classes" do
+      object = Object.new
+      def object.looksee_index_singleton_test; end
+      Looksee::Index.build.owners(:looksee_index_singleton_test).should == [object.singleton_class]
+    end
+
+    it "should include undefined methods" do
+      temporary_class :C
+      add_methods C, undefined: [:looksee_index_undefined_test]
+      Looksee::Index.build[:looksee_index_undefined_test].should == {C => :undefined}
+    end
+  end
+
+  describe "with a given table" do
+    before do
+      @index = Looksee::Index.new(
+        :f => [Object, :public, Kernel, :private],
+        :g => [Comparable, :public],
+      )
+    end
+
+    describe "#owners" do
+      it "should return the modules defining the named method" do
+        @index.owners(:f).should == [Object, Kernel]
+      end
+
+      it "should accept strings" do
+        @index.owners('g').should == [Comparable]
+      end
+
+      it "should return an empty array if no module defines the method" do
+        @index.owners(:h).should == []
+      end
+    end
+
+    describe "#[]" do
+      it "should return the visibility of the method in each module" do
+        @index[:f].should == {Object => :public, Kernel => :private}
+      end
+
+      it "should return an empty hash if no module defines the method" do
+        @index[:h].should == {}
+      end
+    end
+
+    describe "#include?" do
+      it "should return true if some module defines the method" do
+        @index.include?('f').should == true
+      end
+
+      it "should return false if no module defines the method" do
+        @index.include?(:h).should == false
+      end
+    end
+
+    describe "#names" do
+      it "should return the names of the indexed methods" do
+        @index.names.should == [:f, :g]
+      end
+    end
+
+    describe "#size" do
+      it "should return the number of names indexed" do
+        @index.size.should == 2
+      end
+    end
+
+    describe "#memsize" do
+      it "should return the number of bytes used by the index" do
+        @index.memsize.should be_a(Integer)
+        @index.memsize.should > 0
+      end
+    end
+  end
+end
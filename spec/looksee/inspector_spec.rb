@@ -1,4 +1,5 @@
 require 'spec_helper'
+require 'stringio'
 
 describe Looksee::Inspector do
   include TemporaryClasses
@@ -148,6 +149,229 @@ describe Looksee::Inspector do
         |  ab  ax  ba
       EOS
     end
+
+    it "should match string filters literally, and keep the flags of regexp filters" do
+      add_methods C, public: [:a?, :ab, :Xy, :xz]
+      lookup_path = Looksee::LookupPath.new(@object)
+      inspector = Looksee::Inspector.new(lookup_path, :visibilities => [:public], :filters => ['?', /^x/i])
+      inspector.inspect.should == <<-EOS.demargin.chomp
+        |M
+        |C
+        |  Xy  a?  xz
+      EOS
+    end
+  end
+
+  describe "constants" do
+    before do
+      Looksee.stub(:styles).and_return(Hash.new{'%s'})
+      @object = Object.new
+      temporary_class :C
+      Looksee.adapter.ancestors[@object] = [C]
+      add_methods C, public: [:pub]
+      C.const_set(:X, 1)
+      C.const_set(:Y, 2)
+    end
+
+    it "should not show constants by default" do
+      lookup_path = Looksee::LookupPath.new(@object)
+      inspector = Looksee::Inspector.new(lookup_path, :visibilities => [:public])
+      inspector.inspect.should == <<-EOS.demargin.chomp
+        |C
+        |  pub
+      EOS
+    end
+
+    it "should show constants after the methods if selected" do
+      lookup_path = Looksee::LookupPath.new(@object)
+      inspector = Looksee::Inspector.new(lookup_path, :visibilities => [:public], :constants => true)
+      inspector.inspect.should == <<-EOS.demargin.chomp
+        |C
+        |  pub
+        |  ::X  ::Y
+      EOS
+    end
+
+    it "should show unloaded autoloads with their paths, without loading them" do
+      C.autoload(:Z, '/looksee/nonexistent/z')
+      lookup_path = Looksee::LookupPath.new(@object)
+      inspector = Looksee::Inspector.new(lookup_path, :visibilities => [:public], :constants => true)
+      inspector.inspect.should == <<-EOS.demargin.chomp
+        |C
+        |  pub
+        |  ::X  ::Y  ::Z (/looksee/nonexistent/z)
+      EOS
+    end
+
+    it "should only show constants that match the given filters" do
+      lookup_path = Looksee::LookupPath.new(@object)
+      inspector = Looksee::Inspector.new(lookup_path, :visibilities => [:public], :filters => ['X'], :constants => true)
+      inspector.inspect.should == <<-EOS.demargin.chomp
+        |C
+        |  ::X
+      EOS
+    end
+  end
+
+  describe "memsize" do
+    before do
+      Looksee.stub(:styles).and_return(Hash.new{'%s'})
+      @object = Object.new
+      temporary_class :C
+      Looksee.adapter.ancestors[@object] = [C]
+      add_methods C, public: [:pub]
+      @lookup_path = Looksee::LookupPath.new(@object)
+    end
+
+    it "should annotate each module with the usage of its tables if selected" do
+      usage = {:m_tbl => [88, 1, 4], :callable_m_tbl => [0, 0, 0], :cc_tbl => [152, 4, 8]}
+      Looksee.adapter.stub(:method_table_usage).and_return(usage)
+      inspector = Looksee::Inspector.new(@lookup_path, :visibilities => [:public], :memsize => true)
+      inspector.inspect.should == <<-EOS.demargin.chomp
+        |C  m_tbl 88B 1/4  callable_m_tbl 0B 0/0  cc_tbl 152B 4/8
+        |  pub
+      EOS
+    end
+
+    it "should not annotate modules if usage is unavailable" do
+      inspector = Looksee::Inspector.new(@lookup_path, :visibilities => [:public], :memsize => true)
+      inspector.inspect.should == <<-EOS.demargin.chomp
+        |C
+        |  pub
+      EOS
+    end
+  end
+
+  describe "hot" do
+    before do
+      Looksee.stub(:styles).and_return(Hash.new{'%s'}.update(:hot => '*%s*'))
+      @object = Object.new
+      temporary_module :M
+      temporary_class(:C) { include M }
+      Looksee.adapter.ancestors[@object] = [C, M]
+      add_methods C, public: [:a, :b]
+      add_methods M, public: [:a, :c]
+      @lookup_path = Looksee::LookupPath.new(@object)
+    end
+
+    it "should highlight called methods with their call cache counts if selected" do
+      Looksee.adapter.stub(:call_cache_counts).and_return(C => {:a => 2}, M => {:c => 1})
+      inspector = Looksee::Inspector.new(@lookup_path, :visibilities => [:public, :overridden], :hot => true)
+      inspector.inspect.should == <<-EOS.demargin.chomp
+        |M
+        |  a  *c (1)*
+        |C
+        |  *a (2)*  b
+      EOS
+    end
+
+    it "should not highlight methods if call caches are unavailable" do
+      inspector = Looksee::Inspector.new(@lookup_path, :visibilities => [:public], :hot => true)
+      inspector.inspect.should == <<-EOS.demargin.chomp
+        |M
+        |  c
+        |C
+        |  a  b
+      EOS
+    end
+  end
+
+  describe "census" do
+    it "should annotate each module with its object counts if selected" do
+      Looksee.stub(:styles).and_return(Hash.new{'%s'})
+      object = Object.new
+      temporary_module :M
+      temporary_class(:C) { include M }
+      Looksee.adapter.ancestors[object] = [C, M]
+      census = Looksee::Census.new({C => 10}, {C => 2}, {M => 4})
+      Looksee::Census.stub(:build).and_return(census)
+      inspector = Looksee::Inspector.new(Looksee::LookupPath.new(object), :visibilities => [:public], :census => true)
+      inspector.inspect.should == <<-EOS.demargin.chomp
+        |M  extends 4
+        |C  10 instances, 2 singletons
+      EOS
+    end
+  end
+
+  describe "#each_chunk" do
+    before do
+      Looksee.stub(:styles).and_return(Hash.new{'%s'})
+      @object = Object.new
+      temporary_class :C
+      temporary_module :M
+      Looksee.adapter.ancestors[@object] = [C, M]
+      add_methods M, public: [:m]
+      add_methods C, public: [:c]
+      @inspector = Looksee::Inspector.new(Looksee::LookupPath.new(@object), :visibilities => [:public])
+    end
+
+    it "should yield each module's output, separated by newlines" do
+      @inspector.each_chunk.to_a.should == ["M\n  m", "\n", "C\n  c"]
+    end
+
+    it "should make up the #inspect output" do
+      @inspector.each_chunk.to_a.join.should == @inspector.inspect
+    end
+
+    it "should not scan later modules if overridden methods are shown as other methods are" do
+      scanned = []
+      Looksee.adapter.define_singleton_method(:instance_method_visibilities_by_symbol) do |mod|
+        scanned << mod
+        super(mod)
+      end
+      inspector = Looksee::Inspector.new(Looksee::LookupPath.new(@object), :visibilities => [:public, :overridden])
+      inspector.each_chunk.first.should == "M\n  m"
+      scanned.should == [M]
+    end
+  end
+
+  describe "#write" do
+    before do
+      Looksee.stub(:styles).and_return(Hash.new{'%s'})
+      @object = Object.new
+      temporary_class :C
+      Looksee.adapter.ancestors[@object] = [C]
+      add_methods C, public: [:c]
+      @inspector = Looksee::Inspector.new(Looksee::LookupPath.new(@object), :visibilities => [:public])
+    end
+
+    it "should write the #inspect output and a newline to the given IO" do
+      io = StringIO.new
+      @inspector.write(io).should equal(io)
+      io.string.should == "C\n  c\n"
+    end
+  end
+
+  describe "#page_output" do
+    let(:tmp) { "#{ROOT}/spec/tmp" }
+
+    before do
+      Looksee.stub(:styles).and_return(Hash.new{'%s'})
+      @object = Object.new
+      temporary_class :C
+      Looksee.adapter.ancestors[@object] = [C]
+      add_methods C, public: [:c]
+      @inspector = Looksee::Inspector.new(Looksee::LookupPath.new(@object), :visibilities => [:public])
+      FileUtils.mkdir_p tmp
+    end
+
+    after do
+      FileUtils.rm_rf tmp
+    end
+
+    it "should write the output to the pager command" do
+      @inspector.page_output("cat > #{tmp}/out").should be_nil
+      File.read("#{tmp}/out").should == "C\n  c\n"
+    end
+
+    it "should stop rendering when the pager quits" do
+      chunks = 0
+      @inspector.define_singleton_method(:each_chunk) do |&block|
+        loop { chunks += 1; block.call('x' * 4096) }
+      end
+      @inspector.page_output('true').should be_nil
+      chunks.should > 0
+    end
   end
 
   describe "#pretty_print" do
@@ -162,6 +386,18 @@ describe Looksee::Inspector do
       add_methods C, public: ['aa']
       @lookup_path = Looksee::LookupPath.new(@object)
       @inspector = Looksee::Inspector.new(@lookup_path, :visibilities => [:public])
+      @stdout = $stdout
+      $stdout = StringIO.new
+    end
+
+    after do
+      $stdout = @stdout
+    end
+
+    def terminal
+      io = StringIO.new
+      def io.tty?; true; end
+      io
     end
 
     it "should produce the same output as #inspect" do
@@ -190,6 +426,71 @@ describe Looksee::Inspector do
         EOS
       end
     end
+
+    it "should write straight to standard output if pp prints there and it is a terminal" do
+      $stdout = terminal
+      pp = PP.new($stdout)
+      @inspector.pretty_print(pp)
+      $stdout.string.should == "\e[1;31mC\e[0m\n  \e[1;31maa\e[0m"
+    end
+
+    it "should not write to standard output if pp prints elsewhere" do
+      $stdout = terminal
+      pp = PP.new
+      @inspector.pretty_print(pp)
+      pp.output.should == "\e[1;31mC\e[0m\n  \e[1;31maa\e[0m"
+      $stdout.string.should == ''
+    end
+
+    it "should not write IRB results straight to standard output" do
+      begin
+        require 'irb/color_printer'
+      rescue LoadError
+        next
+      end
+      $stdout = terminal
+      pp = IRB::ColorPrinter.new
+      @inspector.pretty_print(pp)
+      pp.output.should == "\e[1;31mC\e[0m\n  \e[1;31maa\e[0m"
+      $stdout.string.should == ''
+    end
+
+    it "should write straight to standard output when printed with PP.pp" do
+      $stdout = terminal
+      PP.pp(@inspector, $stdout)
+      $stdout.string.should == "\e[1;31mC\e[0m\n  \e[1;31maa\e[0m\n"
+    end
+
+    it "should not write straight to standard output when nested in another object" do
+      $stdout = terminal
+      PP.pp([@inspector], $stdout)
+      $stdout.string.should == "[\e[1;31mC\e[0m\n  \e[1;31maa\e[0m]\n"
+    end
+
+    it "should not write straight to standard output if streaming is off" do
+      Looksee.stub(:stream).and_return(false)
+      $stdout = terminal
+      pp = PP.new($stdout)
+      @inspector.pretty_print(pp)
+      pp.flush
+      $stdout.string.should == "\e[1;31mC\e[0m\n  \e[1;31maa\e[0m"
+    end
+
+    it "should not page when nested in another object" do
+      $stdout = terminal
+      inspector = Looksee::Inspector.new(@lookup_path, :visibilities => [:public], :page => true)
+      inspector.define_singleton_method(:page_output) { |*| raise 'paged' }
+      PP.pp([inspector], $stdout)
+      $stdout.string.should == "[\e[1;31mC\e[0m\n  \e[1;31maa\e[0m]\n"
+    end
+
+    it "should not page if pp prints elsewhere" do
+      $stdout = terminal
+      inspector = Looksee::Inspector.new(@lookup_path, :visibilities => [:public], :page => true)
+      pp = PP.new
+      inspector.pretty_print(pp)
+      pp.output.should == "\e[1;31mC\e[0m\n  \e[1;31maa\e[0m"
+    end
   end
 
   describe ".styles" do
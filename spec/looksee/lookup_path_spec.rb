@@ -34,16 +34,16 @@ describe Looksee::LookupPath do
 
     it "should include methods of all visibilities, including overridden ones" do
       @lookup_path.entries[0].methods.should == {
-        'pub1' => :public, 'pub2' => :public,
-        'pro1' => :protected, 'pro2' => :protected,
-        'pri1' => :private, 'pri2' => :private,
-        'und1' => :undefined, 'und2' => :undefined,
+        :pub1 => :public, :pub2 => :public,
+        :pro1 => :protected, :pro2 => :protected,
+        :pri1 => :private, :pri2 => :private,
+        :und1 => :undefined, :und2 => :undefined,
       }
       @lookup_path.entries[1].methods.should == {
-        'pub1' => :public, 'pub2' => :public,
-        'pro1' => :protected, 'pro2' => :protected,
-        'pri1' => :private, 'pri2' => :private,
-        'und1' => :undefined, 'und2' => :undefined,
+        :pub1 => :public, :pub2 => :public,
+        :pro1 => :protected, :pro2 => :protected,
+        :pri1 => :private, :pri2 => :private,
+        :und1 => :undefined, :und2 => :undefined,
       }
     end
 
@@ -51,6 +51,62 @@ describe Looksee::LookupPath do
       @lookup_path.entries[0].overridden?('pub1').should == false
       @lookup_path.entries[1].overridden?('pub1').should == true
     end
+
+    it "should only count methods defined in earlier entries as overriding" do
+      temporary_module(:N) { def f; end; def g; end }
+      temporary_class(:D) { include N; def g; end }
+      temporary_class(:E, superclass: D) { def f; end }
+      object = E.new
+      Looksee.adapter.ancestors[object] = [E, D, N]
+      entries = Looksee::LookupPath.new(object).entries
+      entries[0].overridden?(:f).should == false
+      entries[1].overridden?(:g).should == false
+      entries[2].overridden?(:f).should == true
+      entries[2].overridden?(:g).should == true
+      entries[2].overridden?(:h).should == false
+    end
+  end
+
+  describe "scanning" do
+    use_test_adapter
+
+    before do
+      Looksee.stub(:method_cache).and_return(nil)
+      temporary_class(:C) { def f; end }
+      temporary_class(:D) { def g; end }
+      @object = Object.new
+      Looksee.adapter.ancestors[@object] = [C, D]
+      @scanned = []
+      scanned = @scanned
+      adapter = Looksee.adapter
+      adapter.define_singleton_method(:instance_method_visibilities_by_symbol) do |mod|
+        scanned << mod
+        super(mod)
+      end
+    end
+
+    it "should not scan any modules until their methods are needed" do
+      Looksee::LookupPath.new(@object)
+      @scanned.should == []
+    end
+
+    it "should only scan modules up to the one defining the method found" do
+      Looksee::LookupPath.new(@object).find_entry(:f).module.should == C
+      @scanned.should == [C]
+    end
+
+    it "should only scan earlier modules to tell if a method is overridden" do
+      Looksee::LookupPath.new(@object).entries[1].overridden?(:g).should == false
+      @scanned.should == [C]
+    end
+
+    it "should scan each module at most once" do
+      lookup_path = Looksee::LookupPath.new(@object)
+      lookup_path.find_entry(:g)
+      lookup_path.entries[1].overridden?(:g)
+      lookup_path.entries.each { |entry| entry.methods }
+      @scanned.should == [C, D]
+    end
   end
 
   describe "#find" do
@@ -89,12 +145,52 @@ describe Looksee::LookupPath do
     end
   end
 
+  describe "with refinements" do
+    before do
+      temporary_class(:C) { def f; end; def g; end }
+      temporary_module(:R) { refine(C) { def f; end } }
+      temporary_module(:S) { refine(C) { def f; end; def h; end } }
+      @object = C.new
+    end
+
+    def refinement(refiner)
+      NATIVE_ADAPTER.refinement_for(refiner, C)
+    end
+
+    it "should not include refinements by default" do
+      lookup_path = Looksee::LookupPath.new(@object)
+      lookup_path.entries.first.module.should == C
+    end
+
+    it "should include active refinements before the module they refine" do
+      lookup_path = Looksee::LookupPath.new(@object, using: [R])
+      lookup_path.entries.map { |entry| entry.module }.first(2).should == [refinement(R), C]
+    end
+
+    it "should give precedence to refinements activated later" do
+      lookup_path = Looksee::LookupPath.new(@object, using: [R, S])
+      lookup_path.entries.map { |entry| entry.module }.first(3).should ==
+        [refinement(S), refinement(R), C]
+    end
+
+    it "should mark methods in the refined module as overridden" do
+      lookup_path = Looksee::LookupPath.new(@object, using: [R])
+      lookup_path.entries[1].overridden?('f').should == true
+      lookup_path.entries[1].overridden?('g').should == false
+    end
+
+    it "should find refined methods in their refinement" do
+      lookup_path = Looksee::LookupPath.new(@object, using: [S])
+      lookup_path.find('h').owner.should == refinement(S)
+    end
+  end
+
   describe 'Looksee::LookupPath::Entry' do
     it "should iterate over methods in alphabetical order" do
       temporary_class(:C)
       add_methods(C, public: [:a, :c, :b])
       @lookup_path = Looksee::LookupPath.new(C.new)
-      @lookup_path.entries.first.map{|name, visibility| name}.should == ['a', 'b', 'c']
+      @lookup_path.entries.first.map{|name, visibility| name}.should == [:a, :b, :c]
     end
   end
 end
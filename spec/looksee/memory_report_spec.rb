@@ -0,0 +1,61 @@
+require 'spec_helper'
+
+describe Looksee::MemoryReport do
+  include TemporaryClasses
+  use_test_adapter
+
+  def usage(m_tbl, callable_m_tbl, cc_tbl)
+    {:m_tbl => [m_tbl, 1, 4], :callable_m_tbl => [callable_m_tbl, 1, 4], :cc_tbl => [cc_tbl, 1, 4]}
+  end
+
+  describe ".build" do
+    before do
+      temporary_module :M
+      temporary_class :C
+      temporary_class :D
+      usages = {M => usage(10, 0, 0), C => usage(10, 20, 30), D => usage(40, 0, 0)}
+      Looksee.adapter.stub(:method_table_usage) { |mod| usages[mod] }
+    end
+
+    it "should rank the given modules by the memory used by their tables" do
+      report = Looksee::MemoryReport.build(:modules => [M, C, D])
+      report.rows.map { |row| row.module }.should == [C, D, M]
+      report.rows.map { |row| row.memsize }.should == [60, 40, 10]
+    end
+
+    it "should keep only the largest rows if a limit is given" do
+      report = Looksee::MemoryReport.build(:modules => [M, C, D], :limit => 2)
+      report.rows.map { |row| row.module }.should == [C, D]
+    end
+
+    it "should leave out modules whose usage is unavailable" do
+      report = Looksee::MemoryReport.build(:modules => [M, Object])
+      report.rows.map { |row| row.module }.should == [M]
+    end
+
+    it "should report on the modules in the heap by default" do
+      report = Looksee::MemoryReport.build
+      report.rows.map { |row| row.module }.should include(C)
+    end
+
+    it "should total the memory used by all rows" do
+      Looksee::MemoryReport.build(:modules => [M, C, D]).memsize.should == 110
+    end
+  end
+
+  describe "#inspect" do
+    it "should list each module with its usage, largest first" do
+      Looksee.stub(:styles).and_return(Hash.new{'%s'})
+      temporary_class :C
+      temporary_class :D
+      report = Looksee::MemoryReport.new([
+        Looksee::MemoryReport::Row.new(C, usage(100, 20, 30)),
+        Looksee::MemoryReport::Row.new(D, usage(8, 0, 0)),
+      ])
+      report.inspect.should == <<-EOS.demargin.chomp
+        |150B  C  m_tbl 100B 1/4  callable_m_tbl 20B 1/4  cc_tbl 30B 1/4
+        |  8B  D  m_tbl 8B 1/4  callable_m_tbl 0B 1/4  cc_tbl 0B 1/4
+      EOS
+    end
+  end
+end
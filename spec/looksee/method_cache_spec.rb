@@ -0,0 +1,120 @@
+require 'spec_helper'
+
+describe Looksee::MethodCache do
+  include TemporaryClasses
+
+  before do
+    @cache = Looksee::MethodCache.new(100)
+  end
+
+  describe "#fetch" do
+    it "should return the visibilities of the module's methods" do
+      temporary_class :C
+      add_methods C, public: [:pub], private: [:pri]
+      @cache.fetch(C).should == {:pub => :public, :pri => :private}
+    end
+
+    it "should return a frozen hash" do
+      temporary_class :C
+      @cache.fetch(C).should be_frozen
+    end
+
+    it "should not rescan a module which has not changed" do
+      temporary_class :C
+      add_methods C, public: [:f]
+      @cache.fetch(C).should equal(@cache.fetch(C))
+    end
+
+    it "should rescan a module when a method is added" do
+      temporary_class :C
+      add_methods C, public: [:f]
+      @cache.fetch(C)
+      add_methods C, public: [:g]
+      @cache.fetch(C).should == {:f => :public, :g => :public}
+    end
+
+    it "should rescan a module when a method's visibility changes" do
+      temporary_class :C
+      add_methods C, public: [:f]
+      @cache.fetch(C)
+      C.send(:private, :f)
+      @cache.fetch(C).should == {:f => :private}
+    end
+
+    it "should rescan a module when a method is undefined" do
+      temporary_class :C
+      add_methods C, public: [:f]
+      @cache.fetch(C)
+      C.send(:undef_method, :f)
+      @cache.fetch(C).should == {:f => :undefined}
+    end
+
+    it "should not confuse a reloaded class with the original" do
+      original = Class.new { def f; end }
+      @cache.fetch(original)
+      reloaded = Class.new { def g; end }
+      @cache.fetch(reloaded).should == {:g => :public}
+      @cache.fetch(original).should == {:f => :public}
+    end
+
+    it "should track the total number of methods held" do
+      temporary_class :C
+      temporary_class :D
+      add_methods C, public: [:f, :g]
+      add_methods D, public: [:h]
+      @cache.fetch(C)
+      @cache.fetch(D)
+      @cache.size.should == 3
+      add_methods C, public: [:i]
+      @cache.fetch(C)
+      @cache.size.should == 4
+    end
+
+    it "should evict the least recently used tables when full" do
+      @cache = Looksee::MethodCache.new(3)
+      temporary_class :C
+      temporary_class :D
+      temporary_class :E
+      add_methods C, public: [:f]
+      add_methods D, public: [:g]
+      add_methods E, public: [:h, :i]
+      c_methods = @cache.fetch(C)
+      d_methods = @cache.fetch(D)
+      @cache.fetch(C)
+      @cache.fetch(E)
+      @cache.size.should == 3
+      @cache.fetch(C).should equal(c_methods)
+      @cache.fetch(D).should_not equal(d_methods)
+    end
+
+    it "should not cache tables larger than the maximum size" do
+      @cache = Looksee::MethodCache.new(1)
+      temporary_class :C
+      add_methods C, public: [:f, :g]
+      @cache.fetch(C)
+      @cache.size.should == 0
+    end
+
+    describe "when the adapter cannot compute signatures" do
+      use_test_adapter
+
+      it "should not cache anything" do
+        temporary_class :C
+        add_methods C, public: [:f]
+        @cache.fetch(C).should_not equal(@cache.fetch(C))
+        @cache.size.should == 0
+      end
+    end
+  end
+
+  describe "#clear" do
+    it "should remove all cached tables" do
+      temporary_class :C
+      add_methods C, public: [:f]
+      methods = @cache.fetch(C)
+      @cache.clear
+      @cache.size.should == 0
+      @cache.fetch(C).should_not equal(methods)
+    end
+  end
+end
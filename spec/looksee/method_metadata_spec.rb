@@ -0,0 +1,50 @@
+require 'spec_helper'
+
+describe Looksee::MethodMetadata do
+  before do
+    @metadata = Looksee::MethodMetadata.new(
+      ['f', 'g', 'h'],
+      [:public, :private, :undefined],
+      [:iseq, :cfunc, :undefined],
+      ['f', 'x', 'h'],
+      [Object, Kernel, Object],
+      [0, -1, nil],
+    )
+  end
+
+  describe "#size" do
+    it "should return the number of methods" do
+      @metadata.size.should == 3
+    end
+  end
+
+  describe "#names_of_type" do
+    it "should return the names of the methods of the given type" do
+      @metadata.names_of_type(:cfunc).should == ['g']
+    end
+
+    it "should return an empty array if there are no methods of the given type" do
+      @metadata.names_of_type(:bmethod).should == []
+    end
+  end
+
+  describe "#[]" do
+    it "should return the metadata for the named method" do
+      @metadata['g'].should == {
+        :visibility => :private,
+        :type => :cfunc,
+        :original_name => 'x',
+        :original_owner => Kernel,
+        :arity => -1,
+      }
+    end
+
+    it "should accept symbols" do
+      @metadata[:f][:type].should == :iseq
+    end
+
+    it "should return nil if there is no such method" do
+      @metadata['z'].should be_nil
+    end
+  end
+end
@@ -0,0 +1,37 @@
+require 'spec_helper'
+
+describe Looksee::Resolution do
+  include TemporaryClasses
+
+  before do
+    temporary_module(:M) { def f; end }
+    temporary_class(:C) { include M; private; def f; end }
+  end
+
+  it "should find the owner and visibility of the method called" do
+    resolution = Looksee.resolve(C.new, 'f')
+    resolution.name.should == :f
+    resolution.should be_found
+    resolution.owner.should == C
+    resolution.visibility.should == :private
+    resolution.chain.should == [[C, :private], [M, :public]]
+  end
+
+  it "should not be found if the method is undefined first" do
+    temporary_class(:D, superclass: C) { undef_method :f }
+    resolution = Looksee.resolve(D.new, :f)
+    resolution.should_not be_found
+    resolution.owner.should be_nil
+    resolution.visibility.should be_nil
+    resolution.chain.should == [[D, :undefined]]
+  end
+
+  it "should not be found if no module defines the method" do
+    Looksee.resolve(C.new, :g).chain.should == []
+  end
+
+  it "should show each module defining the method" do
+    Looksee.stub(:styles).and_return(Hash.new{'%s'})
+    Looksee.resolve(C.new, :f).inspect.should == "C  f\nM  f"
+  end
+end
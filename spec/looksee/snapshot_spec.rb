@@ -0,0 +1,102 @@
+require 'spec_helper'
+
+describe Looksee::Snapshot do
+  include TemporaryClasses
+
+  let(:tmp) { "#{ROOT}/spec/tmp" }
+  let(:path) { "#{tmp}/snapshot.lsnap" }
+
+  before do
+    FileUtils.mkdir_p tmp
+    temporary_class :C
+    temporary_module :M
+    temporary_class :D, :superclass => C
+    add_methods C, :public => [:a, :b], :private => [:p]
+    add_methods M, :public => [:m]
+    D.send :include, M
+    add_methods D, :public => [:a], :protected => [:d], :undefined => [:b]
+    Looksee::Snapshot.dump(path)
+    @snapshot = Looksee::Snapshot.load(path)
+  end
+
+  after do
+    FileUtils.rm_rf tmp
+  end
+
+  it "should record the process and time it was taken in" do
+    @snapshot.pid.should == Process.pid
+    @snapshot.ruby_description.should == RUBY_DESCRIPTION
+    (Time.now - @snapshot.created_at).should < 60
+  end
+
+  it "should include the modules of the process" do
+    @snapshot.modules.should include('C', 'D', 'M', 'Object')
+  end
+
+  it "should include modules nested in modules which override constant lookup" do
+    M.const_set(:X, Class.new)
+    [:autoload?, :const_defined?, :const_get].each do |name|
+      M.define_singleton_method(name) { |*| raise 'called' }
+    end
+    Looksee::Snapshot.dump(path)
+    Looksee::Snapshot.load(path).modules.should include('M::X')
+  end
+
+  it "should record the ancestors of each module" do
+    @snapshot.ancestors('D').should == Looksee.adapter.lookup_modules(D.new).map { |mod| Looksee.adapter.describe_module(mod) }
+    @snapshot.ancestors('M').should == ['M']
+  end
+
+  it "should record the methods of each module with their visibilities" do
+    @snapshot.method_table_for('D').should == {'a' => :public, 'd' => :protected, 'b' => :undefined}
+    @snapshot.method_table_for('C')['p'].should == :private
+  end
+
+  it "should record the type and source location of each method" do
+    file, line = C.instance_method(:a).source_location
+    info = @snapshot.method_info('C', 'a')
+    info[:visibility].should == :public
+    info[:file].should == file
+    info[:line].should == line
+    @snapshot.method_info('C', 'x').should be_nil
+  end
+
+  it "should give lookup path entries the recorded source locations" do
+    entry = @snapshot.lookup_path('D').entries.find { |e| e.description == 'C' }
+    entry.source_locations['a'].should == C.instance_method(:a).source_location
+    entry.source_locations.names.sort.should == ['a', 'b', 'p']
+  end
+
+  it "should leave Object#methods alone" do
+    @snapshot.methods.should include(:method_table_for)
+  end
+
+  it "should raise an ArgumentError for modules not in the snapshot" do
+    lambda { @snapshot.ancestors('NoSuchModule') }.should raise_error(ArgumentError)
+  end
+
+  it "should inspect lookup paths like Looksee.[]" do
+    Looksee.stub(:styles).and_return(Hash.new{'%s'})
+    @snapshot.look('D', :public, :protected, :overridden, :undefined).inspect.should ==
+      Looksee[D.new, :public, :protected, :overridden, :undefined].inspect
+  end
+
+  it "should raise a FormatError for files which are not snapshots" do
+    File.write(path, 'x' * 100)
+    lambda { Looksee::Snapshot.load(path) }.should raise_error(Looksee::Snapshot::FormatError)
+  end
+
+  describe ".dump_on_signal" do
+    it "should dump a snapshot when the signal is received" do
+      previous = Looksee::Snapshot.dump_on_signal('USR2', "#{tmp}/signal-%p.lsnap")
+      begin
+        Process.kill('USR2', Process.pid)
+        signal_path = "#{tmp}/signal-#{Process.pid}.lsnap"
+        50.times { File.exist?(signal_path) ? break : sleep(0.1) }
+        Looksee::Snapshot.load(signal_path).modules.should include('D')
+      ensure
+        Signal.trap('USR2', previous)
+      end
+    end
+  end
+end
@@ -0,0 +1,36 @@
+require 'spec_helper'
+
+describe Looksee::SourceLocations do
+  before do
+    @locations = Looksee::SourceLocations.new(
+      ['a.rb', 'b.rb'],
+      ['f', 'g', 'h', 'i'],
+      [1, 0, nil, 1],
+      [20, 5, nil, 10],
+    )
+  end
+
+  describe "#[]" do
+    it "should return the file and line of the named method" do
+      @locations['f'].should == ['b.rb', 20]
+    end
+
+    it "should accept symbols" do
+      @locations[:g].should == ['a.rb', 5]
+    end
+
+    it "should return nil if the method has no source location" do
+      @locations['h'].should be_nil
+    end
+
+    it "should return nil if there is no such method" do
+      @locations['z'].should be_nil
+    end
+  end
+
+  describe "#group_by_file" do
+    it "should return the methods defined in each file, in line order" do
+      @locations.group_by_file.should == {'a.rb' => ['g'], 'b.rb' => ['i', 'f']}
+    end
+  end
+end
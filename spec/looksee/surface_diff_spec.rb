@@ -0,0 +1,112 @@
+require 'spec_helper'
+
+describe Looksee::SurfaceDiff do
+  include TemporaryClasses
+
+  let(:tmp) { "#{ROOT}/spec/tmp" }
+
+  before do
+    FileUtils.mkdir_p tmp
+    temporary_class :C
+    temporary_class :D, :superclass => C
+    temporary_class :E, :superclass => D
+    temporary_module :M
+    add_methods C, :public => [:a, :b, :c]
+    add_methods M, :public => [:m]
+  end
+
+  after do
+    FileUtils.rm_rf tmp
+  end
+
+  def diff
+    before = Looksee::Snapshot.dump("#{tmp}/before.lsnap")
+    yield
+    after = Looksee::Snapshot.dump("#{tmp}/after.lsnap")
+    Looksee.diff_surface(before, after)
+  end
+
+  def changes_in(diff, *descriptions)
+    diff.changes.select { |change| descriptions.include?(change.module) }.map(&:to_a)
+  end
+
+  it "should report methods added, removed and changing visibility" do
+    result = diff do
+      C.send :remove_method, :a
+      C.send :private, :b
+      add_methods C, :protected => [:n]
+      C.send :undef_method, :c
+    end
+    changes_in(result, 'C').should == [
+      [:removed, 'C', 'a', :public, nil],
+      [:visibility, 'C', 'b', :public, :private],
+      [:visibility, 'C', 'c', :public, :undefined],
+      [:added, 'C', 'n', nil, :protected],
+    ]
+  end
+
+  it "should report methods moving owner in descendants" do
+    result = diff do
+      add_methods D, :public => [:a]
+    end
+    changes_in(result, 'C', 'D', 'E').should == [
+      [:added, 'D', 'a', nil, :public],
+      [:owner, 'E', 'a', 'C', 'D'],
+    ]
+  end
+
+  it "should report methods gained by changing ancestors" do
+    result = diff do
+      E.send :include, M
+    end
+    changes_in(result, 'E').should == [[:owner, 'E', 'm', nil, 'M']]
+  end
+
+  it "should be empty if nothing changed" do
+    result = diff {}
+    changes_in(result, 'C', 'D', 'E', 'M').should == []
+  end
+
+  it "should accept loaded snapshots" do
+    path = Looksee::Snapshot.dump("#{tmp}/snapshot.lsnap")
+    snapshot = Looksee::Snapshot.load(path)
+    Looksee::SurfaceDiff.build(snapshot, snapshot).should be_empty
+  end
+
+  describe "rendering" do
+    before do
+      Looksee.stub(:styles).and_return(Hash.new{'%s'})
+      @diff = Looksee::SurfaceDiff.new([
+        Looksee::SurfaceDiff::Change.new(:added, 'C', 'n', nil, :public),
+        Looksee::SurfaceDiff::Change.new(:removed, 'C', 'a', :private, nil),
+        Looksee::SurfaceDiff::Change.new(:visibility, 'C', 'b', :public, :private),
+        Looksee::SurfaceDiff::Change.new(:owner, 'E', 'a', 'C', 'D'),
+        Looksee::SurfaceDiff::Change.new(:owner, 'E', 'm', nil, 'M'),
+      ])
+    end
+
+    it "should group changes under each module" do
+      @diff.inspect.should == <<-EOS.demargin.chomp
+        |C
+        |  + n (public)
+        |  - a (private)
+        |  ~ b public -> private
+        |E
+        |  > a C -> D
+        |  > m nothing -> M
+      EOS
+    end
+
+    it "should write one JSON object per change" do
+      require 'json'
+      lines = @diff.to_ndjson.lines.map { |line| JSON.parse(line) }
+      lines.size.should == 5
+      lines[0].should == {'kind' => 'added', 'module' => 'C', 'name' => 'n', 'from' => nil, 'to' => 'public'}
+      lines[3].should == {'kind' => 'owner', 'module' => 'E', 'name' => 'a', 'from' => 'C', 'to' => 'D'}
+    end
+
+    it "should count changes by kind" do
+      @diff.counts.should == {:added => 1, :removed => 1, :visibility => 1, :owner => 2}
+    end
+  end
+end